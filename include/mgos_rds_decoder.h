@@ -63,6 +63,176 @@ void mgos_rds_decoder_set_oda_callbacks(struct rds_decoder* decoder,
                                         ClearODAFunc clear_cb,
                                         void* cb_data);
 
+/**
+ * Set the function called when decoding changes values.
+ *
+ * @param decoder   The RDS decoder.
+ * @param change_cb The function to call, or NULL for none.
+ * @param cb_data   Data to be passed to the callback when invoked.
+ */
+void mgos_rds_decoder_set_change_callback(struct rds_decoder* decoder,
+                                          ValuesChangedFunc change_cb,
+                                          void* cb_data);
+
+/**
+ * Creates a snapshot, through which decoded data can be shared with other
+ * tasks.
+ *
+ * @return opaque handle (NULL if an error occurred).
+ */
+struct rds_snapshot* mgos_rds_snapshot_create(void);
+
+/**
+ * Delete the snapshot.
+ */
+void mgos_rds_snapshot_delete(struct rds_snapshot* snapshot);
+
+/**
+ * Copy the most recently published data out of the snapshot.
+ *
+ * @return The version of the copy read.
+ */
+uint32_t mgos_rds_snapshot_read(const struct rds_snapshot* snapshot,
+                                struct rds_data* rds);
+
+/**
+ * Return the version of the most recently published copy.
+ */
+uint32_t mgos_rds_snapshot_version(const struct rds_snapshot* snapshot);
+
+/**
+ * Publish the decoder's data to \p snapshot whenever it changes.
+ */
+void mgos_rds_decoder_set_snapshot(struct rds_decoder* decoder,
+                                   struct rds_snapshot* snapshot);
+
+/**
+ * Creates a ring buffer of groups, to pass groups from an interrupt handler
+ * to a decoding task.
+ *
+ * @param capacity The maximum number of pending groups. This must be a power
+ *                 of two.
+ *
+ * @return opaque handle (NULL if an error occurred).
+ */
+struct rds_block_ring* mgos_rds_block_ring_create(uint16_t capacity);
+
+/**
+ * Delete the ring buffer.
+ */
+void mgos_rds_block_ring_delete(struct rds_block_ring* ring);
+
+/**
+ * Add a group to the ring buffer. This is safe to call from an interrupt
+ * handler.
+ *
+ * @return true if added, false if dropped because the ring is full.
+ */
+bool mgos_rds_block_ring_push(struct rds_block_ring* ring,
+                              const struct rds_blocks* blocks);
+
+/**
+ * Decode all pending groups in the ring buffer.
+ *
+ * @return The number of groups decoded.
+ */
+size_t mgos_rds_block_ring_drain(struct rds_block_ring* ring,
+                                 struct rds_decoder* decoder);
+
+/**
+ * Return the number of groups waiting to be decoded.
+ */
+size_t mgos_rds_block_ring_size(const struct rds_block_ring* ring);
+
+/**
+ * Return the number of groups dropped because the ring buffer was full.
+ */
+uint32_t mgos_rds_block_ring_dropped(const struct rds_block_ring* ring);
+
+/**
+ * Creates a synchronizer, which receives the raw RDS data stream and
+ * produces groups to decode.
+ *
+ * @return opaque handle (NULL if an error occurred).
+ */
+struct rds_bitstream* mgos_rds_bitstream_create(
+    const struct rds_bitstream_config* config);
+
+/**
+ * Delete the bitstream synchronizer.
+ */
+void mgos_rds_bitstream_delete(struct rds_bitstream* bs);
+
+/**
+ * Discard any partially received group, and lose synchronization.
+ */
+void mgos_rds_bitstream_reset(struct rds_bitstream* bs);
+
+/**
+ * Receive the next bit of the data stream.
+ */
+void mgos_rds_bitstream_push_bit(struct rds_bitstream* bs, bool bit);
+
+/**
+ * Receive the next bits of the data stream, packed most significant bit
+ * first.
+ */
+void mgos_rds_bitstream_push_bits(struct rds_bitstream* bs,
+                                  const uint8_t* data,
+                                  size_t num_bits);
+
+/**
+ * Receive the next bits of the data stream as soft decisions
+ * (log-likelihood ratios, positive for a 1).
+ */
+void mgos_rds_bitstream_push_soft_bits(struct rds_bitstream* bs,
+                                       const int8_t* llrs,
+                                       size_t num_bits);
+
+/**
+ * Is the synchronizer synchronized to the block boundaries?
+ */
+bool mgos_rds_bitstream_synced(const struct rds_bitstream* bs);
+
+/**
+ * Return the counts of data received since creation or the last reset.
+ */
+const struct rds_bitstream_stats* mgos_rds_bitstream_get_stats(
+    const struct rds_bitstream* bs);
+
+/**
+ * Return the function used by \p decoder to decode the data of group type
+ * \p gt.
+ *
+ * @return The handler, or NULL if groups of this type are not decoded.
+ */
+DecodeGroupFunc mgos_rds_decoder_get_group_handler(
+    const struct rds_decoder* decoder,
+    struct rds_group_type gt);
+
+/**
+ * Set the function used to decode the data of group type \p gt.
+ *
+ * The handler is called once the group's PI code, PTY and statistics have
+ * been decoded, with the blocks of each group of type \p gt. To also decode
+ * the data in the default way call the default handler (See
+ * mgos_rds_decoder_default_group_handler) from \p handler.
+ *
+ * @param decoder The RDS decoder.
+ * @param gt      The group type.
+ * @param handler The function to decode the group, or NULL to skip the data
+ *                of this group type.
+ */
+void mgos_rds_decoder_set_group_handler(struct rds_decoder* decoder,
+                                        struct rds_group_type gt,
+                                        DecodeGroupFunc handler);
+
+/**
+ * Return the library's function to decode the data of group type \p gt.
+ */
+DecodeGroupFunc mgos_rds_decoder_default_group_handler(
+    struct rds_group_type gt);
+
 /**
  * Decode the RDS data from the supplied \p blocks.
  *
@@ -75,11 +245,103 @@ void mgos_rds_decoder_set_oda_callbacks(struct rds_decoder* decoder,
 void mgos_rds_decoder_decode(struct rds_decoder* decoder,
                              const struct rds_blocks* blocks);
 
+/**
+ * Decode the RDS data from the supplied \p blocks, received at \p timestamp.
+ *
+ * This is the same as mgos_rds_decoder_decode, but every value updated by
+ * the blocks has its rds_data::update_time set to \p timestamp. Values
+ * decoded with mgos_rds_decoder_decode have a timestamp of zero.
+ *
+ * @param decoder   The RDS decoder to use for decoding.
+ * @param blocks    The RDS block data to decode.
+ * @param timestamp The time the blocks were received. This can be any
+ *                  monotonic clock, in any units, chosen by the host.
+ */
+void mgos_rds_decoder_decode_ts(struct rds_decoder* decoder,
+                                const struct rds_blocks* blocks,
+                                int64_t timestamp);
+
+/**
+ * Decode an array of groups, in order.
+ *
+ * The decoded data is the same as from calling mgos_rds_decoder_decode for each
+ * group, but changes are reported once, for the whole batch:
+ * rds_data::changed_values holds the values changed by any of the groups,
+ * and the change callback and snapshot (if any) are notified once, after the
+ * last group. Values are updated with a timestamp of zero.
+ *
+ * @param decoder The RDS decoder to use for decoding.
+ * @param groups  The groups to decode.
+ * @param n       The number of groups in \p groups.
+ */
+void mgos_rds_decoder_decode_batch(struct rds_decoder* decoder,
+                                   const struct rds_blocks* groups,
+                                   size_t n);
+
 /**
  * Reset the decoder (and any decoded data) to the default state.
  */
 void mgos_rds_decoder_reset(struct rds_decoder* decoder);
 
+/**
+ * Is \p freq in the AF table?
+ */
+bool mgos_rds_af_table_contains(const struct rds_af_table* table,
+                                const struct rds_freq* freq);
+
+/**
+ * List the frequencies in the AF table in ascending order.
+ *
+ * @return The number of frequencies written to \p freqs.
+ */
+uint16_t mgos_rds_af_table_get_freqs(const struct rds_af_table* table,
+                                     struct rds_freq* freqs,
+                                     uint16_t max);
+
+/**
+ * Add the frequencies of \p src to \p dst.
+ */
+void mgos_rds_af_table_union(struct rds_af_table* dst,
+                             const struct rds_af_table* src);
+
+/**
+ * Creates a pool of RDS decoders, one per station.
+ *
+ * @param config The pool configuration parameters.
+ *
+ * @return opaque handle (NULL if an error occurred).
+ */
+struct rds_decoder_pool* mgos_rds_decoder_pool_create(
+    const struct rds_decoder_pool_config* config);
+
+/**
+ * Delete the RDS decoder pool, and all of its stations.
+ */
+void mgos_rds_decoder_pool_delete(struct rds_decoder_pool* pool);
+
+/**
+ * Decode the supplied \p blocks using the decoder of the station that sent
+ * them.
+ *
+ * @return The station's decoded data, or NULL if the group was ignored.
+ */
+const struct rds_data* mgos_rds_decoder_pool_decode(
+    struct rds_decoder_pool* pool,
+    const struct rds_blocks* blocks);
+
+/**
+ * Return the decoded data of the station with \p pi_code, or NULL if the
+ * station is not in the pool.
+ */
+const struct rds_data* mgos_rds_decoder_pool_find(
+    const struct rds_decoder_pool* pool,
+    uint16_t pi_code);
+
+/**
+ * Return the number of stations in the pool.
+ */
+uint16_t mgos_rds_decoder_pool_count(const struct rds_decoder_pool* pool);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
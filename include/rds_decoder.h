@@ -23,16 +23,59 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+/** \addtogroup RDS_ENABLE Optional features.
+ * @{
+ * Each optional feature is compiled in when its constant is nonzero (the
+ * default). A disabled feature's decoding code, and its fields in rds_data,
+ * are removed, which saves code size and memory on small targets. The
+ * library and every file using rds_data must be built with the same values,
+ * so set these as compiler definitions (the CMake RDS_ENABLE_* options) and
+ * not in a source file.
+ */
+
+#if !defined(RDS_ENABLE_AF)
+#define RDS_ENABLE_AF 1  ///< Alternative frequencies (0A).
+#endif
+#if !defined(RDS_ENABLE_CLOCK)
+#define RDS_ENABLE_CLOCK 1  ///< Clock-time and date (4A).
+#endif
+#if !defined(RDS_ENABLE_DEV_STATS)
+#define RDS_ENABLE_DEV_STATS 1  ///< Group statistics (See RDS_DEV).
+#endif
+#if !defined(RDS_ENABLE_EON)
+#define RDS_ENABLE_EON 1  ///< Enhanced Other Networks (14A, 14B).
+#endif
+#if !defined(RDS_ENABLE_EWS)
+#define RDS_ENABLE_EWS 1  ///< Emergency Warning System (9A).
+#endif
+#if !defined(RDS_ENABLE_ODA)
+#define RDS_ENABLE_ODA 1  ///< Open Data Applications (3A).
+#endif
+#if !defined(RDS_ENABLE_PTYN)
+#define RDS_ENABLE_PTYN 1  ///< Program Type Name (10A).
+#endif
+#if !defined(RDS_ENABLE_RT)
+#define RDS_ENABLE_RT 1  ///< Radiotext (2A, 2B).
+#endif
+#if !defined(RDS_ENABLE_TDC)
+#define RDS_ENABLE_TDC 1  ///< Transparent Data Channels (5A, 5B).
+#endif
+
+/** @}*/
+
+#if RDS_ENABLE_DEV_STATS && !defined(RDS_DEV)
 /**
- * Define this constant to expose data used during library development.
+ * Defined to expose data used during library development.
  */
 #define RDS_DEV
+#endif
 
 // clang-format off
 
@@ -92,6 +135,7 @@ struct rds_group_type {
 };
 
 #define NUM_TDC 32  ///< The number of transparent data codes.
+#define RDS_NUM_GROUP_TYPES 32  ///< Group type codes (0..15) * versions (A/B).
 #define TDC_LEN 32  ///< The # of transparent data bytes we keep (per code).
 
 // clang-format off
@@ -128,27 +172,52 @@ enum rds_packet_counts {
 
 #endif // defined(RDS_DEV)
 
+/**
+ * The bit numbers of the values in rds_values.
+ */
+enum rds_value_idx {
+  RDS_AF_IDX      = 0,
+  RDS_CLOCK_IDX   = 1,
+  RDS_EWS_IDX     = 2,
+  RDS_FBT_IDX     = 3,
+  RDS_MC_IDX      = 4,
+  RDS_PIC_IDX     = 5,
+  RDS_PI_CODE_IDX = 6,
+  RDS_PS_IDX      = 7,
+  RDS_PTY_IDX     = 8,
+  RDS_PTYN_IDX    = 9,
+  RDS_RT_IDX      = 10,
+  RDS_SLC_IDX     = 11,
+  RDS_TDC_IDX     = 12,
+  RDS_TA_CODE_IDX = 13,
+  RDS_TP_CODE_IDX = 14,
+  RDS_MS_IDX      = 15,
+  RDS_EON_IDX     = 16,
+
+  RDS_NUM_VALUES  = 17  // Number of values in this enum.
+};
+
 /**
  * Constants to represent trhe values in rds_data that are valid.
  */
 enum rds_values {
-  RDS_AF      = 0x00001,
-  RDS_CLOCK   = 0x00002,
-  RDS_EWS     = 0x00004,
-  RDS_FBT     = 0x00008,
-  RDS_MC      = 0x00010,
-  RDS_PIC     = 0x00020, ///< Program item number code.
-  RDS_PI_CODE = 0x00040, ///< Program identification code.
-  RDS_PS      = 0x00080,
-  RDS_PTY     = 0x00100,
-  RDS_PTYN    = 0x00200,
-  RDS_RT      = 0x00400,
-  RDS_SLC     = 0x00800,
-  RDS_TDC     = 0x01000,
-  RDS_TA_CODE = 0x02000,
-  RDS_TP_CODE = 0x04000,
-  RDS_MS      = 0x08000,
-  RDS_EON     = 0x10000,
+  RDS_AF      = 1 << RDS_AF_IDX,
+  RDS_CLOCK   = 1 << RDS_CLOCK_IDX,
+  RDS_EWS     = 1 << RDS_EWS_IDX,
+  RDS_FBT     = 1 << RDS_FBT_IDX,
+  RDS_MC      = 1 << RDS_MC_IDX,
+  RDS_PIC     = 1 << RDS_PIC_IDX,     ///< Program item number code.
+  RDS_PI_CODE = 1 << RDS_PI_CODE_IDX, ///< Program identification code.
+  RDS_PS      = 1 << RDS_PS_IDX,
+  RDS_PTY     = 1 << RDS_PTY_IDX,
+  RDS_PTYN    = 1 << RDS_PTYN_IDX,
+  RDS_RT      = 1 << RDS_RT_IDX,
+  RDS_SLC     = 1 << RDS_SLC_IDX,
+  RDS_TDC     = 1 << RDS_TDC_IDX,
+  RDS_TA_CODE = 1 << RDS_TA_CODE_IDX,
+  RDS_TP_CODE = 1 << RDS_TP_CODE_IDX,
+  RDS_MS      = 1 << RDS_MS_IDX,
+  RDS_EON     = 1 << RDS_EON_IDX,
 };
 
 /**
@@ -191,44 +260,68 @@ typedef enum rds_af_encoding {
 
 /**
  * Represents a frequency in a frequency band.
+ *
+ * This is packed into 16 bits, as AF tables hold many of them.
  */
 struct rds_freq {
-  enum rds_band band;  ///< The frequency band.
+  uint16_t band : 1;  ///< The frequency band (an rds_band).
 
   /**
-   * How does this frequency relate to the tuned frequency.
+   * How does this frequency relate to the tuned frequency (an rds_af_attrib).
    *
    * Only valid when this instance is used to specify an alternative frequency.
    */
-  enum rds_af_attrib attrib;
+  uint16_t attrib : 1;
 
   /// If band is UHF then frequency is in multiples of 10 MHz.
   ///   e.g. 885 = 88.5 MHz or 1079 = 107.9 MHz.
   /// Otherwise frequency is in KHz.
   ///   e.g. 531 = 531 KHz.
-  uint16_t freq;
+  uint16_t freq : 14;
 };
 
+/**
+ * The number of 32-bit words in each bitset of an rds_af_table.
+ *
+ * Each frequency is one bit, indexed by its AF code (RBDS spec 3.2.1.6.1):
+ * LF/MF codes 1..135 are bits 0..134, and UHF codes 1..204 are bits
+ * 160..363. Ascending bit order is therefore ascending frequency order, with
+ * all LF/MF frequencies before the UHF frequencies.
+ */
+#define RDS_AF_SET_WORDS 12
+
+/**
+ * The maximum number of alternative frequencies decoded into one table.
+ */
+#define RDS_AF_TABLE_MAX 25
+
 /**
  * A table of frequencies.
+ *
+ * The frequencies are held as bitsets (See RDS_AF_SET_WORDS). Use
+ * rds_af_table_get_freqs to list them, and rds_af_table_contains to test for
+ * one.
  */
 struct rds_af_table {
   struct rds_freq tuned_freq;  ///< The tuned frequency (method B only).
-  uint8_t count;               ///< Number of entries in table below.
-  struct rds_freq entry[25];   ///< Array of alternative frequencies.
+  uint16_t count;              ///< Number of frequencies in the table.
+  uint32_t freqs[RDS_AF_SET_WORDS];  ///< The alternative frequencies.
+  /// The frequencies (a subset of freqs) which are regional variants
+  /// (AF_ATTRIB_REG_VARIANT) of the tuned frequency.
+  uint32_t reg_variants[RDS_AF_SET_WORDS];
 };
 
 /**
  * Used to decode alternative frequencies into an rds_af_table.
  */
 struct rds_af_decode_table {
-  struct rds_af_table table;   ///< The table where new freqs will be inserted.
-  rds_af_encoding enc_method;  ///< Encoding method.
+  struct rds_af_table table;  ///< The table where new freqs will be inserted.
+  uint8_t enc_method;        ///< Encoding method (an rds_af_encoding).
   struct {
-    enum rds_band band;               ///< Band(s) for following freqs.
-    rds_af_encoding prev_enc_method;  ///< Previous table encoding method.
-    uint8_t expected_cnt;             ///< The number of freqs to follow.
-  } pvt;                              ///< Private data used during decoding.
+    uint8_t band;             ///< Band (an rds_band) for following freqs.
+    uint8_t prev_enc_method;  ///< Previous table encoding method.
+    uint8_t expected_cnt;     ///< The number of freqs to follow.
+  } pvt;                      ///< Private data used during decoding.
 };
 
 /**
@@ -284,30 +377,63 @@ struct rds_clock_t {
  * etc. represent accumulated values.
  */
 struct rds_data {
-  uint16_t pi_code;    ///< Program Identification Code.
-  struct rds_pic pic;  ///< Program item number code.
-  uint8_t pty;         ///< The Program Type (PTY) code.
-  bool tp_code;        ///< Traffic Program Code (RDS standard 3.2.1.3).
-  bool ta_code;        ///< Traffic announcement code. See 3.2.1.3.
-  bool music;          ///< true if music, false if speech. See 3.2.1.4.
+  // The values written by (nearly) every group are first: these fields, to
+  // the end of ps, are the first 64 bytes. Each group also writes the
+  // update_time of the values it sets and, with RDS_DEV, the stats, which
+  // follow. So a group writes up to six 64-byte cache lines at the start.
+  uint16_t pi_code;  ///< Program Identification Code.
+  uint8_t pty;       ///< The Program Type (PTY) code.
+  bool tp_code;      ///< Traffic Program Code (RDS standard 3.2.1.3).
+  bool ta_code;      ///< Traffic announcement code. See 3.2.1.3.
+  bool music;        ///< true if music, false if speech. See 3.2.1.4.
+
+  /// Bitmask (See rds_values) of valid values in this field.
+  uint32_t valid_values;
+
+  /// Bitmask (See rds_values) of the values changed by the last call to
+  /// rds_decoder_decode (or _decode_ts, _decode_batch). A value changes when
+  /// it first becomes valid, or when its decoded value differs. For example
+  /// RDS_PS is set when a new PS text is complete, and RDS_AF when a new
+  /// alternative frequency is received.
+  uint32_t changed_values;
+
+  /// The timestamp of the most recently decoded group.
+  int64_t timestamp;
 
   // Note: NONE of the strings in this structure are null terminated!
   struct {
     uint8_t display[8];  ///< PS text to display.
+    /**
+     * true once all eight characters have been received. With advanced PS
+     * decoding each must also have been validated, and this is false while
+     * the text is in transition (display keeps the last complete text).
+     */
+    bool complete;
     struct {
       uint8_t hi_prob[8];      ///< Temporary PS text (high probability).
       uint8_t lo_prob[8];      ///< Temporary PS text (low probability).
       uint8_t hi_prob_cnt[8];  ///< Hit count of high probability PS text.
+      uint8_t received;        ///< Characters received (one bit each).
     } pvt;                     ///< PS decoder private data.
   } ps;                        ///< The Program Service data.
 
-  struct {
-    struct rds_rt a;             ///< RT A text.
-    struct rds_rt b;             ///< RT B text.
-    enum rds_rt_text decode_rt;  ///< Which RT text currently being decoded.
-  } rt;                          ///< The Radiotext data.
+  /// The timestamp of the group which last updated each value, indexed by
+  /// rds_value_idx. For example update_time[RDS_RT_IDX].
+  int64_t update_time[RDS_NUM_VALUES];
 
-  struct rds_clock_t clock;  ///< The clock time (current broadcast time).
+  struct rds_pic pic;  ///< Program item number code.
+
+#if defined(RDS_DEV)
+  struct {
+    int counts[PKTCNT_NUM];  ///< The number of received packets for some types.
+    struct {
+      uint16_t a;           ///< Number of A versions for the group.
+      uint16_t b;           ///< Number of B versions for the group.
+    } groups[16];           ///< Group counts.
+    uint16_t data_cnt;      ///< # of times RDS data was received.
+    uint16_t blckb_errors;  ///< # of times block B exceeded BLERB_MAX.
+  } stats;
+#endif  // defined(RDS_DEV)
 
   struct {
     bool la;  ///< Linkage Actuator. RDSM spec. (3.2.1.8.3).
@@ -325,13 +451,57 @@ struct rds_data {
     } data;                     ///< payload of the SLC packet.
   } slc;                        ///< Slow labeling codes.
 
+#if RDS_ENABLE_RT
+  struct {
+    struct rds_rt a;             ///< RT A text.
+    struct rds_rt b;             ///< RT B text.
+    enum rds_rt_text decode_rt;  ///< Which RT text currently being decoded.
+  } rt;                          ///< The Radiotext data.
+#endif  // RDS_ENABLE_RT
+
+#if RDS_ENABLE_PTYN
   struct {
     uint8_t display[8];  ///< The PTYN to display.
     bool last_ab;        ///< Last displayed AB flag value.
   } ptyn;                ///< Program Type Name.
+#endif  // RDS_ENABLE_PTYN
+
+#if RDS_ENABLE_CLOCK
+  struct rds_clock_t clock;  ///< The clock time (current broadcast time).
+#endif  // RDS_ENABLE_CLOCK
 
+  // Larger values which are seldom (or never) sent by most stations. These
+  // are last so that they don't share cache lines with the values above.
+
+#if RDS_ENABLE_EWS
+  struct {
+    struct rds_block b;  ///< EWS block B data. (non EWS bits set to zero.)
+    struct rds_block c;  ///< EWS block C data.
+    struct rds_block d;  ///< EWS block D data.
+  } ews;                 ///< Emergency Warning System data.
+#endif  // RDS_ENABLE_EWS
+
+#if RDS_ENABLE_ODA
+  uint8_t oda_cnt;  ///< the number of currently active ODA's.
+  struct {
+    uint16_t id;               ///< Application Identificion (AID).
+    struct rds_group_type gt;  ///< Group type where data is received.
+    uint16_t pkt_count;        ///< Number of packets of this AID received.
+  } oda[10];                   ///< The ODA group types active.
+  struct {
+    /// For each group type (indexed by code * 2 + (version B ? 1 : 0)) one
+    /// plus the index in oda[] of the ODA it carries, or zero if none.
+    uint8_t by_group[RDS_NUM_GROUP_TYPES];
+    /// Hash table (by AID) of one plus each ODA's index in oda[], or zero.
+    uint8_t by_aid[16];
+  } oda_pvt;  ///< Private data used to route groups to an ODA.
+#endif  // RDS_ENABLE_ODA
+
+#if RDS_ENABLE_AF
   struct rds_af_table_group af;  ///< Alternative frequencies.
+#endif  // RDS_ENABLE_AF
 
+#if RDS_ENABLE_EON
   struct {
     struct {
       uint8_t ps[8];                  ///< Program Service data.
@@ -347,39 +517,14 @@ struct rds_data {
       struct rds_freq on_freq;        ///< Other network frequency.
     } maps[5];                        ///< Mapping table of this=>other freqs.
   } eon;                              ///< Enhanced Other Network data.
+#endif  // RDS_ENABLE_EON
 
-  uint8_t oda_cnt;  ///< the number of currently active ODA's.
-  struct {
-    uint16_t id;               ///< Application Identificion (AID).
-    struct rds_group_type gt;  ///< Group type where data is received.
-    uint16_t pkt_count;        ///< Number of packets of this AID received.
-  } oda[10];                   ///< The ODA group types active.
-
+#if RDS_ENABLE_TDC
   struct {
     uint8_t data[NUM_TDC][TDC_LEN];  ///< TDC data.
     uint8_t curr_channel;            ///< Current TDC channel from 5A.
   } tdc;
-
-  struct {
-    struct rds_block b;  ///< EWS block B data. (non EWS bits set to zero.)
-    struct rds_block c;  ///< EWS block C data.
-    struct rds_block d;  ///< EWS block D data.
-  } ews;                 ///< Emergency Warning System data.
-
-#if defined(RDS_DEV)
-  struct {
-    int counts[PKTCNT_NUM];  ///< The number of received packets for some types.
-    struct {
-      uint16_t a;           ///< Number of A versions for the group.
-      uint16_t b;           ///< Number of B versions for the group.
-    } groups[16];           ///< Group counts.
-    uint16_t data_cnt;      ///< # of times RDS data was received.
-    uint16_t blckb_errors;  ///< # of times block B exceeded BLERB_MAX.
-  } stats;
-#endif  // defined(RDS_DEV)
-
-  /// Bitmask (See rds_values) of valid values in this field.
-  uint32_t valid_values;
+#endif  // RDS_ENABLE_TDC
 };
 
 /**
@@ -411,6 +556,31 @@ typedef void (*DecodeODAFunc)(uint16_t app_id,
  */
 typedef void (*ClearODAFunc)(void* cb_data);
 
+/**
+ * A function called when decoding changes values.
+ *
+ * @param rds            The decoded data.
+ * @param changed_values Bitmask (See rds_values) of the changed values. This
+ *                       is never zero.
+ * @param cb_data        The data passed to rds_decoder_set_change_callback.
+ */
+typedef void (*ValuesChangedFunc)(const struct rds_data* rds,
+                                  uint32_t changed_values,
+                                  void* cb_data);
+
+struct rds_decoder;
+
+/**
+ * A function to decode the data of one group type.
+ *
+ * @param decoder The RDS decoder decoding the group. This can be passed to a
+ *                default group handler.
+ * @param blocks  The group's blocks. Block B has no more than BLERB_MAX
+ *                errors.
+ */
+typedef void (*DecodeGroupFunc)(const struct rds_decoder* decoder,
+                                const struct rds_blocks* blocks);
+
 /**
  * Creates a new RDS decoder.
  *
@@ -445,6 +615,279 @@ void rds_decoder_set_oda_callbacks(struct rds_decoder* decoder,
                                    ClearODAFunc clear_cb,
                                    void* cb_data);
 
+/**
+ * Set the function called when decoding changes values.
+ *
+ * The callback is called at most once per call to rds_decoder_decode (or
+ * _decode_ts, _decode_batch), after decoding, with the same bitmask as
+ * rds_data::changed_values. It is not called if nothing changed, so hosts
+ * need not compare rds_data to detect updates.
+ *
+ * @param decoder   The RDS decoder.
+ * @param change_cb The function to call, or NULL for none.
+ * @param cb_data   Data to be passed to the callback when invoked.
+ */
+void rds_decoder_set_change_callback(struct rds_decoder* decoder,
+                                     ValuesChangedFunc change_cb,
+                                     void* cb_data);
+
+/**
+ * Creates a snapshot, through which decoded data can be shared with other
+ * threads.
+ *
+ * One thread decodes, and publishes copies of its rds_data to the snapshot.
+ * Any number of other threads can read the latest copy at any time. The
+ * copy is protected by a sequence lock: readers never block the decoding
+ * thread, and never see a partially written copy (e.g. half updated PS or
+ * RT text). Initially the snapshot holds no valid values.
+ *
+ * @return opaque handle (NULL if an error occurred).
+ */
+struct rds_snapshot* rds_snapshot_create(void);
+
+/**
+ * Delete the snapshot. No thread may be using it.
+ */
+void rds_snapshot_delete(struct rds_snapshot* snapshot);
+
+/**
+ * Publish a copy of \p rds to the snapshot.
+ *
+ * This must only be called by one thread (usually the decoding thread). It
+ * never waits for readers. Most hosts will instead use
+ * rds_decoder_set_snapshot.
+ */
+void rds_snapshot_publish(struct rds_snapshot* snapshot,
+                          const struct rds_data* rds);
+
+/**
+ * Copy the most recently published data out of the snapshot.
+ *
+ * This can be called by any thread. If a copy is published while this is
+ * reading, it retries until it has read a complete copy.
+ *
+ * @return The version of the copy read. See rds_snapshot_version.
+ */
+uint32_t rds_snapshot_read(const struct rds_snapshot* snapshot,
+                           struct rds_data* rds);
+
+/**
+ * Return the version of the most recently published copy.
+ *
+ * This increases by one each time a copy is published, so readers can
+ * cheaply check for new data before calling rds_snapshot_read.
+ */
+uint32_t rds_snapshot_version(const struct rds_snapshot* snapshot);
+
+/**
+ * Publish the decoder's data to \p snapshot whenever it changes.
+ *
+ * The data is published when set, after each decode call which changes a
+ * value (see rds_data::changed_values), and on reset. Fields which are not
+ * values, such as the RDS_DEV stats, are therefore only as current as the
+ * last change.
+ *
+ * @param decoder  The RDS decoder.
+ * @param snapshot The snapshot to publish to, or NULL to stop publishing.
+ *                 This must outlive its use by the decoder.
+ */
+void rds_decoder_set_snapshot(struct rds_decoder* decoder,
+                              struct rds_snapshot* snapshot);
+
+/**
+ * Creates a ring buffer of groups, to pass groups from the context in which
+ * they are received (e.g. an interrupt handler) to a decoding task.
+ *
+ * The ring is lock-free, but only for one producer and one consumer.
+ *
+ * @param capacity The maximum number of pending groups. This must be a power
+ *                 of two.
+ *
+ * @return opaque handle (NULL if an error occurred).
+ */
+struct rds_block_ring* rds_block_ring_create(uint16_t capacity);
+
+/**
+ * Delete the ring buffer. Neither the producer nor consumer may be using it.
+ */
+void rds_block_ring_delete(struct rds_block_ring* ring);
+
+/**
+ * Add a group to the ring buffer.
+ *
+ * This is called by the producer, and is safe to call from an interrupt
+ * handler: it copies the blocks and does not decode them. If the ring is
+ * full the group is dropped and counted (see rds_block_ring_dropped).
+ *
+ * @return true if added, false if dropped.
+ */
+bool rds_block_ring_push(struct rds_block_ring* ring,
+                         const struct rds_blocks* blocks);
+
+/**
+ * Decode all pending groups in the ring buffer, in the order added.
+ *
+ * This is called by the consumer. The groups are decoded in batches as if by
+ * rds_decoder_decode_batch.
+ *
+ * @param ring    The ring buffer.
+ * @param decoder The decoder with which to decode the groups.
+ *
+ * @return The number of groups decoded.
+ */
+size_t rds_block_ring_drain(struct rds_block_ring* ring,
+                            struct rds_decoder* decoder);
+
+/**
+ * Return the number of groups waiting to be decoded.
+ */
+size_t rds_block_ring_size(const struct rds_block_ring* ring);
+
+/**
+ * Return the number of groups dropped because the ring buffer was full.
+ */
+uint32_t rds_block_ring_dropped(const struct rds_block_ring* ring);
+
+/**
+ * A function called with each group received by an rds_bitstream.
+ */
+typedef void (*BitstreamGroupFunc)(const struct rds_blocks* blocks,
+                                   void* cb_data);
+
+/**
+ * The RDS bitstream synchronizer configuration parameters.
+ */
+struct rds_bitstream_config {
+  BitstreamGroupFunc group_cb;  ///< Called with each received group.
+  void* cb_data;                ///< User data passed to the callback.
+};
+
+/**
+ * Counts of the data received by an RDS bitstream synchronizer.
+ */
+struct rds_bitstream_stats {
+  uint32_t bits;                   ///< Bits received.
+  uint32_t blocks;                 ///< Blocks received while synchronized.
+  uint32_t corrected_blocks;       ///< Blocks with a corrected burst error.
+  uint32_t uncorrectable_blocks;   ///< Blocks which couldn't be corrected.
+  uint32_t soft_corrected_blocks;  ///< Blocks improved by soft decisions.
+  uint32_t groups;                 ///< Groups passed to the callback.
+  uint32_t syncs;                  ///< Times synchronization was acquired.
+  uint32_t sync_losses;            ///< Times synchronization was lost.
+};
+
+/**
+ * Creates a synchronizer, which receives the raw 1187.5 bit/s RDS data
+ * stream (e.g. demodulated by an SDR) and produces groups to decode.
+ *
+ * Block boundaries are found by searching, bit by bit, for two blocks with
+ * valid offset words (A, B, C, C' or D) in sequence. Once synchronized,
+ * each block is checked, burst errors of up to five bits are corrected,
+ * and each group is passed to the callback with the block error counts
+ * (See BLER_*) set accordingly. Synchronization is kept through noise until
+ * more than 45 of the last 50 blocks have errors.
+ *
+ * @param config The synchronizer configuration parameters.
+ *
+ * @return opaque handle (NULL if an error occurred).
+ */
+struct rds_bitstream* rds_bitstream_create(
+    const struct rds_bitstream_config* config);
+
+/**
+ * Delete the bitstream synchronizer.
+ */
+void rds_bitstream_delete(struct rds_bitstream* bs);
+
+/**
+ * Discard any partially received group, lose synchronization and clear the
+ * stats. This should be called when tuning to a new station.
+ */
+void rds_bitstream_reset(struct rds_bitstream* bs);
+
+/**
+ * Receive the next bit of the data stream.
+ *
+ * @param bs  The bitstream synchronizer.
+ * @param bit The (differentially decoded) data bit.
+ */
+void rds_bitstream_push_bit(struct rds_bitstream* bs, bool bit);
+
+/**
+ * Receive the next bits of the data stream.
+ *
+ * @param bs       The bitstream synchronizer.
+ * @param data     The bits, packed most significant bit first.
+ * @param num_bits The number of bits in \p data.
+ */
+void rds_bitstream_push_bits(struct rds_bitstream* bs,
+                             const uint8_t* data,
+                             size_t num_bits);
+
+/**
+ * Receive the next bits of the data stream as soft decisions.
+ *
+ * Each bit is a log-likelihood ratio: positive for a 1, negative for a 0,
+ * with a magnitude from 0 (unknown) to 127 (certain), and about 64 for a
+ * clean signal. Once synchronized, a block received entirely as soft
+ * decisions which fails its checkword is Chase decoded: the five least
+ * reliable bits are flipped in every combination, and the valid block
+ * needing the least confident bits flipped is chosen. The block error count
+ * (See BLER_*) is then set by the total |LLR| of the flipped bits rather
+ * than by their number, so marginal blocks, whose errors are in bits the
+ * demodulator was unsure of, are decoded rather than dropped.
+ *
+ * @param bs       The bitstream synchronizer.
+ * @param llrs     The bits.
+ * @param num_bits The number of bits in \p llrs.
+ */
+void rds_bitstream_push_soft_bits(struct rds_bitstream* bs,
+                                  const int8_t* llrs,
+                                  size_t num_bits);
+
+/**
+ * Is the synchronizer synchronized to the block boundaries?
+ */
+bool rds_bitstream_synced(const struct rds_bitstream* bs);
+
+/**
+ * Return the counts of data received since creation or the last reset.
+ */
+const struct rds_bitstream_stats* rds_bitstream_get_stats(
+    const struct rds_bitstream* bs);
+
+/**
+ * Return the function used by \p decoder to decode the data of group type
+ * \p gt.
+ *
+ * @return The handler, or NULL if groups of this type are not decoded.
+ */
+DecodeGroupFunc rds_decoder_get_group_handler(
+    const struct rds_decoder* decoder,
+    struct rds_group_type gt);
+
+/**
+ * Set the function used to decode the data of group type \p gt.
+ *
+ * The handler is called once the group's PI code, PTY and statistics have
+ * been decoded, with the blocks of each group of type \p gt. To also decode
+ * the data in the default way call the default handler (See
+ * rds_decoder_default_group_handler) from \p handler.
+ *
+ * @param decoder The RDS decoder.
+ * @param gt      The group type.
+ * @param handler The function to decode the group, or NULL to skip the data
+ *                of this group type.
+ */
+void rds_decoder_set_group_handler(struct rds_decoder* decoder,
+                                   struct rds_group_type gt,
+                                   DecodeGroupFunc handler);
+
+/**
+ * Return the library's function to decode the data of group type \p gt.
+ */
+DecodeGroupFunc rds_decoder_default_group_handler(struct rds_group_type gt);
+
 /**
  * Decode the RDS data from the supplied \p blocks.
  *
@@ -457,11 +900,153 @@ void rds_decoder_set_oda_callbacks(struct rds_decoder* decoder,
 void rds_decoder_decode(struct rds_decoder* decoder,
                         const struct rds_blocks* blocks);
 
+/**
+ * Decode the RDS data from the supplied \p blocks, received at \p timestamp.
+ *
+ * This is the same as rds_decoder_decode, but every value updated by the
+ * blocks has its rds_data::update_time set to \p timestamp. Values decoded
+ * with rds_decoder_decode have a timestamp of zero.
+ *
+ * @param decoder   The RDS decoder to use for decoding.
+ * @param blocks    The RDS block data to decode.
+ * @param timestamp The time the blocks were received. This can be any
+ *                  monotonic clock, in any units, chosen by the host.
+ */
+void rds_decoder_decode_ts(struct rds_decoder* decoder,
+                           const struct rds_blocks* blocks,
+                           int64_t timestamp);
+
+/**
+ * Decode an array of groups, in order.
+ *
+ * The decoded data is the same as from calling rds_decoder_decode for each
+ * group, but changes are reported once, for the whole batch:
+ * rds_data::changed_values holds the values changed by any of the groups,
+ * and the change callback and snapshot (if any) are notified once, after the
+ * last group. Values are updated with a timestamp of zero.
+ *
+ * @param decoder The RDS decoder to use for decoding.
+ * @param groups  The groups to decode.
+ * @param n       The number of groups in \p groups.
+ */
+void rds_decoder_decode_batch(struct rds_decoder* decoder,
+                              const struct rds_blocks* groups,
+                              size_t n);
+
 /**
  * Reset the decoder (and any decoded data) to the default state.
  */
 void rds_decoder_reset(struct rds_decoder* decoder);
 
+/**
+ * Is \p freq in the AF table?
+ *
+ * The frequency's attrib is ignored.
+ */
+bool rds_af_table_contains(const struct rds_af_table* table,
+                           const struct rds_freq* freq);
+
+/**
+ * List the frequencies in the AF table in ascending order: all LF/MF
+ * frequencies, then all UHF frequencies.
+ *
+ * @param table The AF table.
+ * @param freqs Set to the frequencies, with their attributes.
+ * @param max   The size of \p freqs. RDS_AF_TABLE_MAX is enough for any
+ *              decoded table.
+ *
+ * @return The number of frequencies written to \p freqs.
+ */
+uint16_t rds_af_table_get_freqs(const struct rds_af_table* table,
+                                struct rds_freq* freqs,
+                                uint16_t max);
+
+/**
+ * Add the frequencies of \p src to \p dst, e.g. to collect the frequencies of
+ * all of a station's method B tables.
+ *
+ * A frequency already in \p dst keeps its attribute. The tuned frequency of
+ * \p dst is unchanged.
+ */
+void rds_af_table_union(struct rds_af_table* dst,
+                        const struct rds_af_table* src);
+
+/**
+ * A function called when a station is evicted from a decoder pool.
+ *
+ * Pooled decoders never call an ODA clear callback, as it couldn't say which
+ * station to clear. A host which saves ODA data per station should clear the
+ * evicted station's (\p rds->pi_code) data here instead.
+ */
+typedef void (*EvictStationFunc)(const struct rds_data* rds, void* cb_data);
+
+/**
+ * The RDS decoder pool configuration parameters.
+ */
+struct rds_decoder_pool_config {
+  bool advanced_ps_decoding;  ///< Algorithm when decoding PS text.
+  uint16_t capacity;          ///< The maximum number of stations decoded.
+  DecodeODAFunc oda_decode_cb;  ///< ODA decode callback (may be NULL).
+  EvictStationFunc evict_cb;    ///< Station eviction callback (may be NULL).
+  ValuesChangedFunc change_cb;  ///< Value change callback (may be NULL).
+  void* cb_data;                ///< User data passed to all callbacks.
+};
+
+/**
+ * Creates a pool of RDS decoders, one per station.
+ *
+ * Groups from many stations (e.g. a receiver scanning several frequencies)
+ * can be decoded with a single pool. Each group is decoded by the decoder
+ * of the station with its PI code. The memory for all stations is allocated
+ * up front. Once \p config->capacity stations are in use the least recently
+ * received station is evicted to make room for a new one.
+ *
+ * @param config The pool configuration parameters.
+ *
+ * @return opaque handle (NULL if an error occurred).
+ */
+struct rds_decoder_pool* rds_decoder_pool_create(
+    const struct rds_decoder_pool_config* config);
+
+/**
+ * Delete the RDS decoder pool, and all of its stations.
+ *
+ * @param pool The pool to delete.
+ */
+void rds_decoder_pool_delete(struct rds_decoder_pool* pool);
+
+/**
+ * Decode the supplied \p blocks using the decoder of the station that sent
+ * them.
+ *
+ * The station is identified by the PI code in block A or, for version B
+ * groups, block C. Groups with no valid PI code are ignored.
+ *
+ * @param pool   The RDS decoder pool.
+ * @param blocks The RDS block data to decode.
+ *
+ * @return The station's decoded data, or NULL if the group was ignored. This
+ *         is valid until the station is evicted.
+ */
+const struct rds_data* rds_decoder_pool_decode(
+    struct rds_decoder_pool* pool,
+    const struct rds_blocks* blocks);
+
+/**
+ * Return the decoded data of the station with \p pi_code.
+ *
+ * @return The station's decoded data, or NULL if the station is not in the
+ *         pool. This is valid until the station is evicted.
+ */
+const struct rds_data* rds_decoder_pool_find(
+    const struct rds_decoder_pool* pool,
+    uint16_t pi_code);
+
+/**
+ * Return the number of stations in the pool.
+ */
+uint16_t rds_decoder_pool_count(const struct rds_decoder_pool* pool);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -29,12 +29,19 @@ static const uint8_t AF_FILLER_CODE = 205;
 static const uint8_t AF_MIN_COUNT_CODE = 225;
 static const uint8_t AF_MAX_COUNT_CODE = 249;
 static const uint8_t AF_LF_MF_FOLLOWS = 250;
+static const uint8_t AF_MAX_LF_MF_FREQ_CODE = 135;  // 1602 kHz.
+
+// The first bit of each band in the rds_af_table bitsets.
+static const uint16_t AF_LF_MF_FIRST_BIT = 0;
+static const uint16_t AF_UHF_FIRST_BIT = 160;
 
 /**
- * Does the frequency code represent a frequency?
+ * Does the frequency code represent a frequency in \p band?
  */
-static bool freq_code_is_freq(const uint8_t freq_code) {
-  return (AF_MIN_FREQ_CODE <= freq_code && freq_code <= AF_MAX_FREQ_CODE);
+static bool freq_code_is_freq(const uint8_t freq_code, uint8_t band) {
+  const uint8_t max_code =
+      band == AF_BAND_UHF ? AF_MAX_FREQ_CODE : AF_MAX_LF_MF_FREQ_CODE;
+  return (AF_MIN_FREQ_CODE <= freq_code && freq_code <= max_code);
 }
 
 /**
@@ -48,18 +55,41 @@ static bool freq_lt(const struct rds_freq* a, const struct rds_freq* b) {
   return false;  // Otherwise b is LF/MF and A is UHF.
 }
 
-static int8_t find_af_freq_idx(const struct rds_af_table* table,
-                               const struct rds_freq* freq) {
-  for (uint8_t i = 0; i < table->count; i++) {
-    if (freq_eq(&table->entry[i], freq))
-      return i;
+/**
+ * Find the index of \p freq's bit in the rds_af_table bitsets.
+ *
+ * @return false if \p freq can't be an alternative frequency (it has no AF
+ *         code).
+ */
+static bool freq_bit(const struct rds_freq* freq, uint16_t* bit) {
+  int code;  // The AF code, as converted by af_code_to_freq.
+  if (freq->band == AF_BAND_UHF)
+    code = freq->freq - 875;
+  else if (freq->freq < 531)  // If LF.
+    code = (freq->freq - 153) / 9 + 1;
+  else  // MF
+    code = (freq->freq - 531) / 9 + 16;
+  if (code < 0 || code > UINT8_MAX || !freq_code_is_freq(code, freq->band) ||
+      af_code_to_freq(code, freq->band) != freq->freq) {
+    return false;
   }
-  return -1;
+  *bit = (freq->band == AF_BAND_UHF ? AF_UHF_FIRST_BIT : AF_LF_MF_FIRST_BIT) +
+         code - 1;
+  return true;
 }
 
-static bool freq_in_af_table(const struct rds_af_table* table,
-                             const struct rds_freq* freq) {
-  return find_af_freq_idx(table, freq) != -1;
+/**
+ * Return the frequency of bit \p bit in the rds_af_table bitsets.
+ */
+static struct rds_freq bit_freq(uint16_t bit) {
+  const uint8_t band = bit >= AF_UHF_FIRST_BIT ? AF_BAND_UHF : AF_BAND_LF_MF;
+  const uint8_t first_bit =
+      band == AF_BAND_UHF ? AF_UHF_FIRST_BIT : AF_LF_MF_FIRST_BIT;
+  const struct rds_freq freq = {
+      .band = band,
+      .attrib = AF_ATTRIB_SAME_PROG,
+      .freq = af_code_to_freq(bit - first_bit + 1, band)};
+  return freq;
 }
 
 static void dec_af_expected_count(struct rds_af_decode_table* table) {
@@ -69,30 +99,41 @@ static void dec_af_expected_count(struct rds_af_decode_table* table) {
 }
 
 /**
- * Insert an alternative frequency to end of the AF table.
+ * Insert an alternative frequency into the AF table.
  *
  * @param table  The table to which to add the frequency.
  * @param freq   The frequency.
+ *
+ * @return true if the frequency was added (i.e. it wasn't already in the
+ *         table, and the table isn't full).
  */
 static bool insert_alt_freq(struct rds_af_table* table,
                             const struct rds_freq* freq) {
-  if (table->count >= ARRAY_SIZE(table->entry)) {
-    // Array is full, do nothing (for now).
+  if (table->count >= RDS_AF_TABLE_MAX) {
+    // Table is full, do nothing (for now).
     return false;
   }
 
-  if (freq_in_af_table(table, freq))
+  uint16_t bit;
+  if (!freq_bit(freq, &bit))
+    return false;
+  const uint32_t mask = 1u << (bit % 32);
+  if (table->freqs[bit / 32] & mask)
     return false;
 
-  table->entry[table->count++] = *freq;
+  table->freqs[bit / 32] |= mask;
+  table->reg_variants[bit / 32] |= (uint32_t)freq->attrib << (bit % 32);
+  table->count++;
   return true;
 }
 
 /**
- * Add an alternative frequency to end of the AF table.
+ * Add an alternative frequency to the AF table.
  *
  * @param table  The table to which to add the frequency.
  * @param freq   The frequency.
+ *
+ * @return true if the frequency was added.
  */
 static bool add_alt_freq(struct rds_af_decode_table* table,
                          const struct rds_freq* freq) {
@@ -119,7 +160,7 @@ static bool handle_freq_code(struct rds_af_decode_table* table,
     return true;
   }
   // All others outside of codes which map to frequencies are ignored.
-  const bool handled = !freq_code_is_freq(freq_code);
+  const bool handled = !freq_code_is_freq(freq_code, table->pvt.band);
   if (handled)
     dec_af_expected_count(table);
   return handled;
@@ -129,7 +170,7 @@ static bool handle_freq_code(struct rds_af_decode_table* table,
 /*vvvvvvvvvv EXPORTED FUNCTIONS *vvvvvvvvv*/
 /******************************************/
 
-void decode_freq_table_start_block(struct rds_af_decode_table* table,
+bool decode_freq_table_start_block(struct rds_af_decode_table* table,
                                    uint8_t num_freqs_in_table,
                                    uint8_t second_byte) {
   table->pvt.expected_cnt = num_freqs_in_table;
@@ -139,23 +180,23 @@ void decode_freq_table_start_block(struct rds_af_decode_table* table,
     table->enc_method = table->pvt.prev_enc_method;
 
   if (handle_freq_code(table, second_byte))
-    return;
+    return false;
 
   const struct rds_freq freq = {
       .band = table->pvt.band,
       .attrib = AF_ATTRIB_SAME_PROG,
       .freq = af_code_to_freq(second_byte, table->pvt.band)};
 
-  add_alt_freq(table, &freq);
+  return add_alt_freq(table, &freq);
 }
 
-void decode_freq_table_nth_block(struct rds_af_decode_table* table,
+bool decode_freq_table_nth_block(struct rds_af_decode_table* table,
                                  uint8_t first_byte,
                                  uint8_t second_byte) {
   if (table->pvt.expected_cnt == 0) {
     // Got more frequency codes than we were expecting. Probably missed
     // a block to start a new table, so do nothing.
-    return;
+    return false;
   }
 
   const bool handled_first = handle_freq_code(table, first_byte);
@@ -169,10 +210,11 @@ void decode_freq_table_nth_block(struct rds_af_decode_table* table,
       .attrib = AF_ATTRIB_SAME_PROG,  // May be overridden.
       .freq = af_code_to_freq(second_byte, table->pvt.band)};
 
+  bool added = false;
   if (table->enc_method == AF_EM_UNKNOWN) {
     if (handled_first && handled_second) {
       // Still don't know, figure out next entry.
-      return;
+      return false;
     }
     if (handled_first || handled_second) {
       // If only one handled, but not the second then this must be method A.
@@ -188,7 +230,7 @@ void decode_freq_table_nth_block(struct rds_af_decode_table* table,
       if (table->table.tuned_freq.freq != 0) {
         // Move the frequency, which we saved because we didn't know if this
         // was method A or B, into the table.
-        add_alt_freq(table, &table->table.tuned_freq);
+        added = add_alt_freq(table, &table->table.tuned_freq);
         memset(&table->table.tuned_freq, 0, sizeof(table->table.tuned_freq));
       }
     }
@@ -198,37 +240,75 @@ void decode_freq_table_nth_block(struct rds_af_decode_table* table,
 
   if (table->enc_method == AF_EM_A) {
     if (!handled_first)
-      add_alt_freq(table, &first_freq);
+      added |= add_alt_freq(table, &first_freq);
     if (!handled_second)
-      add_alt_freq(table, &second_freq);
-    return;
+      added |= add_alt_freq(table, &second_freq);
+    return added;
   }
 
   // Method B:
   if (handled_first || handled_second) {
     // Should be a programming error. Method B's should always have
     // two real frequencies.
-    return;
+    return added;
   }
   if (freq_eq(&table->table.tuned_freq, &first_freq)) {
     if (freq_lt(&first_freq, &second_freq))
       second_freq.attrib = AF_ATTRIB_REG_VARIANT;
-    add_alt_freq(table, &second_freq);
+    added = add_alt_freq(table, &second_freq);
   } else if (freq_eq(&table->table.tuned_freq, &second_freq)) {
     if (freq_lt(&first_freq, &second_freq))
       first_freq.attrib = AF_ATTRIB_REG_VARIANT;
-    add_alt_freq(table, &first_freq);
+    added = add_alt_freq(table, &first_freq);
   } else {
 #if defined(RDS_DEV)
     // strcpy(rds->debug, "AF B, but no freq matches tuned.");
 #endif
   }
+  return added;
 }
 
 bool freq_eq(const struct rds_freq* a, const struct rds_freq* b) {
   return a->band == b->band && a->freq == b->freq;
 }
 
+bool rds_af_table_contains(const struct rds_af_table* table,
+                           const struct rds_freq* freq) {
+  uint16_t bit;
+  if (!freq_bit(freq, &bit))
+    return false;
+  return (table->freqs[bit / 32] >> (bit % 32)) & 1;
+}
+
+uint16_t rds_af_table_get_freqs(const struct rds_af_table* table,
+                                struct rds_freq* freqs,
+                                uint16_t max) {
+  uint16_t count = 0;
+  for (uint8_t i = 0; i < RDS_AF_SET_WORDS; i++) {
+    uint32_t word = table->freqs[i];
+    while (word && count < max) {
+      const uint16_t bit = i * 32 + __builtin_ctz(word);
+      freqs[count] = bit_freq(bit);
+      freqs[count].attrib = (table->reg_variants[i] >> (bit % 32)) & 1;
+      count++;
+      word &= word - 1;  // Clear the lowest set bit.
+    }
+  }
+  return count;
+}
+
+void rds_af_table_union(struct rds_af_table* dst,
+                        const struct rds_af_table* src) {
+  uint16_t count = 0;
+  for (uint8_t i = 0; i < RDS_AF_SET_WORDS; i++) {
+    // Only frequencies new to dst take their attribute from src.
+    dst->reg_variants[i] |= src->reg_variants[i] & ~dst->freqs[i];
+    dst->freqs[i] |= src->freqs[i];
+    count += __builtin_popcount(dst->freqs[i]);
+  }
+  dst->count = count;
+}
+
 bool is_freq_code_count(const uint8_t freq_code) {
   return (AF_MIN_COUNT_CODE <= freq_code && freq_code <= AF_MAX_COUNT_CODE);
 }
@@ -57,14 +57,18 @@ uint16_t af_code_to_freq(uint8_t freq_code, enum rds_band band);
 
 /**
  * Decode the very first block in the frequency table.
+ *
+ * @return true if a frequency was added to the table.
  */
-void decode_freq_table_start_block(struct rds_af_decode_table* table,
+bool decode_freq_table_start_block(struct rds_af_decode_table* table,
                                    uint8_t num_freqs_in_table,
                                    uint8_t second_byte);
 
 /**
  * Decode freqnency blocks 2..n of the frequency table.
+ *
+ * @return true if a frequency was added to the table.
  */
-void decode_freq_table_nth_block(struct rds_af_decode_table* table,
+bool decode_freq_table_nth_block(struct rds_af_decode_table* table,
                                  uint8_t first_byte,
                                  uint8_t second_byte);
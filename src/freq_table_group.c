@@ -35,8 +35,10 @@ static int8_t find_af_table_idx(struct rds_af_table_group* group,
 
 /**
  * Decode the very first block in an alt freq table.
+ *
+ * @return true if a table, or a frequency, was added.
  */
-static void decode_af_start_block(struct rds_af_table_group* group,
+static bool decode_af_start_block(struct rds_af_table_group* group,
                                   uint8_t num_freqs_in_table,
                                   uint8_t second_byte) {
   enum rds_af_encoding encoding_method = AF_EM_UNKNOWN;
@@ -57,6 +59,7 @@ static void decode_af_start_block(struct rds_af_table_group* group,
   }
 
   struct rds_af_decode_table* table = NULL;
+  bool added = false;
 
   if (group->pvt.current_table_idx == -1) {
     // TODO: Make AF Method A more robust. Technically the second byte could
@@ -69,10 +72,11 @@ static void decode_af_start_block(struct rds_af_table_group* group,
     if (group->pvt.current_table_idx == -1) {
       if (group->count == ARRAY_SIZE(group->table)) {
         // All tables are in use - can't allocate a new one.
-        return;
+        return false;
       }
       // Allocate a new table.
       group->pvt.current_table_idx = group->count++;
+      added = true;
       table = &group->table[group->pvt.current_table_idx];
       table->enc_method = encoding_method;
 
@@ -86,35 +90,41 @@ static void decode_af_start_block(struct rds_af_table_group* group,
     table = &group->table[group->pvt.current_table_idx];
   }
 
-  decode_freq_table_start_block(&group->table[group->pvt.current_table_idx],
-                                num_freqs_in_table, second_byte);
+  added |= decode_freq_table_start_block(
+      &group->table[group->pvt.current_table_idx], num_freqs_in_table,
+      second_byte);
+  // A single entry table decoded before any other is not (yet) in the group.
+  return added && group->pvt.current_table_idx < group->count;
 }
 
 /**
  * Decode freqnency blocks 2..n of the AF table.
+ *
+ * @return true if a frequency was added.
  */
-static void decode_af_nth_block(struct rds_af_table_group* group,
+static bool decode_af_nth_block(struct rds_af_table_group* group,
                                 uint8_t first_byte,
                                 uint8_t second_byte) {
   if (group->pvt.current_table_idx < 0) {
-    return;
+    return false;
   }
 
-  decode_freq_table_nth_block(&group->table[group->pvt.current_table_idx],
-                              first_byte, second_byte);
+  return decode_freq_table_nth_block(
+      &group->table[group->pvt.current_table_idx], first_byte, second_byte);
 }
 
 /******************************************/
 /*vvvvvvvvvv EXPORTED FUNCTIONS *vvvvvvvvv*/
 /******************************************/
 
-void decode_freq_group_block(struct rds_af_table_group* group,
+bool decode_freq_group_block(struct rds_af_table_group* group,
                              const uint16_t block) {
   const uint8_t first_byte = (uint8_t)(block >> 8);
   const uint8_t second_byte = block & 0xFF;
 
-  if (is_freq_code_count(first_byte))
-    decode_af_start_block(group, freq_code_to_count(first_byte), second_byte);
-  else
-    decode_af_nth_block(group, first_byte, second_byte);
+  if (is_freq_code_count(first_byte)) {
+    return decode_af_start_block(group, freq_code_to_count(first_byte),
+                                 second_byte);
+  }
+  return decode_af_nth_block(group, first_byte, second_byte);
 }
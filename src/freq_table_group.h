@@ -16,12 +16,15 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 
 struct rds_af_table_group;
 
 /**
  * Decode the block data for a group of frequency tables.
+ *
+ * @return true if a table, or a frequency, was added to the group.
  */
-void decode_freq_group_block(struct rds_af_table_group* group,
+bool decode_freq_group_block(struct rds_af_table_group* group,
                              const uint16_t block);
@@ -39,11 +39,173 @@ void mgos_rds_decoder_set_oda_callbacks(struct rds_decoder* decoder,
   rds_decoder_set_oda_callbacks(decoder, decode_cb, clear_cb, cb_data);
 }
 
+void mgos_rds_decoder_set_change_callback(struct rds_decoder* decoder,
+                                          ValuesChangedFunc change_cb,
+                                          void* cb_data) {
+  rds_decoder_set_change_callback(decoder, change_cb, cb_data);
+}
+
+struct rds_snapshot* mgos_rds_snapshot_create(void) {
+  return rds_snapshot_create();
+}
+
+void mgos_rds_snapshot_delete(struct rds_snapshot* snapshot) {
+  rds_snapshot_delete(snapshot);
+}
+
+uint32_t mgos_rds_snapshot_read(const struct rds_snapshot* snapshot,
+                                struct rds_data* rds) {
+  return rds_snapshot_read(snapshot, rds);
+}
+
+uint32_t mgos_rds_snapshot_version(const struct rds_snapshot* snapshot) {
+  return rds_snapshot_version(snapshot);
+}
+
+void mgos_rds_decoder_set_snapshot(struct rds_decoder* decoder,
+                                   struct rds_snapshot* snapshot) {
+  rds_decoder_set_snapshot(decoder, snapshot);
+}
+
+struct rds_block_ring* mgos_rds_block_ring_create(uint16_t capacity) {
+  return rds_block_ring_create(capacity);
+}
+
+void mgos_rds_block_ring_delete(struct rds_block_ring* ring) {
+  rds_block_ring_delete(ring);
+}
+
+bool mgos_rds_block_ring_push(struct rds_block_ring* ring,
+                              const struct rds_blocks* blocks) {
+  return rds_block_ring_push(ring, blocks);
+}
+
+size_t mgos_rds_block_ring_drain(struct rds_block_ring* ring,
+                                 struct rds_decoder* decoder) {
+  return rds_block_ring_drain(ring, decoder);
+}
+
+size_t mgos_rds_block_ring_size(const struct rds_block_ring* ring) {
+  return rds_block_ring_size(ring);
+}
+
+uint32_t mgos_rds_block_ring_dropped(const struct rds_block_ring* ring) {
+  return rds_block_ring_dropped(ring);
+}
+
+struct rds_bitstream* mgos_rds_bitstream_create(
+    const struct rds_bitstream_config* config) {
+  return rds_bitstream_create(config);
+}
+
+void mgos_rds_bitstream_delete(struct rds_bitstream* bs) {
+  rds_bitstream_delete(bs);
+}
+
+void mgos_rds_bitstream_reset(struct rds_bitstream* bs) {
+  rds_bitstream_reset(bs);
+}
+
+void mgos_rds_bitstream_push_bit(struct rds_bitstream* bs, bool bit) {
+  rds_bitstream_push_bit(bs, bit);
+}
+
+void mgos_rds_bitstream_push_bits(struct rds_bitstream* bs,
+                                  const uint8_t* data,
+                                  size_t num_bits) {
+  rds_bitstream_push_bits(bs, data, num_bits);
+}
+
+void mgos_rds_bitstream_push_soft_bits(struct rds_bitstream* bs,
+                                       const int8_t* llrs,
+                                       size_t num_bits) {
+  rds_bitstream_push_soft_bits(bs, llrs, num_bits);
+}
+
+bool mgos_rds_bitstream_synced(const struct rds_bitstream* bs) {
+  return rds_bitstream_synced(bs);
+}
+
+const struct rds_bitstream_stats* mgos_rds_bitstream_get_stats(
+    const struct rds_bitstream* bs) {
+  return rds_bitstream_get_stats(bs);
+}
+
+DecodeGroupFunc mgos_rds_decoder_get_group_handler(
+    const struct rds_decoder* decoder,
+    struct rds_group_type gt) {
+  return rds_decoder_get_group_handler(decoder, gt);
+}
+
+void mgos_rds_decoder_set_group_handler(struct rds_decoder* decoder,
+                                        struct rds_group_type gt,
+                                        DecodeGroupFunc handler) {
+  rds_decoder_set_group_handler(decoder, gt, handler);
+}
+
+DecodeGroupFunc mgos_rds_decoder_default_group_handler(
+    struct rds_group_type gt) {
+  return rds_decoder_default_group_handler(gt);
+}
+
 void mgos_rds_decoder_decode(struct rds_decoder* decoder,
                              const struct rds_blocks* blocks) {
   rds_decoder_decode(decoder, blocks);
 }
 
+void mgos_rds_decoder_decode_ts(struct rds_decoder* decoder,
+                                const struct rds_blocks* blocks,
+                                int64_t timestamp) {
+  rds_decoder_decode_ts(decoder, blocks, timestamp);
+}
+
+void mgos_rds_decoder_decode_batch(struct rds_decoder* decoder,
+                                   const struct rds_blocks* groups,
+                                   size_t n) {
+  rds_decoder_decode_batch(decoder, groups, n);
+}
+
 void mgos_rds_decoder_reset(struct rds_decoder* decoder) {
   rds_decoder_reset(decoder);
 }
+
+bool mgos_rds_af_table_contains(const struct rds_af_table* table,
+                                const struct rds_freq* freq) {
+  return rds_af_table_contains(table, freq);
+}
+
+uint16_t mgos_rds_af_table_get_freqs(const struct rds_af_table* table,
+                                     struct rds_freq* freqs,
+                                     uint16_t max) {
+  return rds_af_table_get_freqs(table, freqs, max);
+}
+
+void mgos_rds_af_table_union(struct rds_af_table* dst,
+                             const struct rds_af_table* src) {
+  rds_af_table_union(dst, src);
+}
+
+struct rds_decoder_pool* mgos_rds_decoder_pool_create(
+    const struct rds_decoder_pool_config* config) {
+  return rds_decoder_pool_create(config);
+}
+
+void mgos_rds_decoder_pool_delete(struct rds_decoder_pool* pool) {
+  rds_decoder_pool_delete(pool);
+}
+
+const struct rds_data* mgos_rds_decoder_pool_decode(
+    struct rds_decoder_pool* pool,
+    const struct rds_blocks* blocks) {
+  return rds_decoder_pool_decode(pool, blocks);
+}
+
+const struct rds_data* mgos_rds_decoder_pool_find(
+    const struct rds_decoder_pool* pool,
+    uint16_t pi_code) {
+  return rds_decoder_pool_find(pool, pi_code);
+}
+
+uint16_t mgos_rds_decoder_pool_count(const struct rds_decoder_pool* pool) {
+  return rds_decoder_pool_count(pool);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// The Program Service hit counts are eight bytes, so they are updated
+// together as one 64-bit word (SIMD within a register).
+
+#define SWAR_HIGH_BITS 0x8080808080808080ull  // The high bit of each byte.
+#define SWAR_ONES 0x0101010101010101ull       // One in each byte.
+
+/**
+ * Return a mask with the high bit set in each byte of \p v which is at least
+ * \p n (1..127).
+ */
+static inline uint64_t swar_at_least(uint64_t v, uint8_t n) {
+  // Setting the high bit of each (7 bit) byte stops the subtraction from
+  // borrowing from its neighbor, and leaves the bit set iff byte >= n.
+  const uint64_t low = (v & ~SWAR_HIGH_BITS) | SWAR_HIGH_BITS;
+  return ((low - n * SWAR_ONES) | v) & SWAR_HIGH_BITS;
+}
+
+/**
+ * Decrement every one of the eight hit counts in \p counts which is greater
+ * than one.
+ */
+static inline void ps_decrement_counts(uint8_t* counts) {
+  uint64_t v;
+  memcpy(&v, counts, sizeof(v));
+  v -= swar_at_least(v, 2) >> 7;
+  memcpy(counts, &v, sizeof(v));
+}
+
+/**
+ * Are all eight hit counts in \p counts at least \p n (1..127)?
+ */
+static inline bool ps_counts_at_least(const uint8_t* counts, uint8_t n) {
+  uint64_t v;
+  memcpy(&v, counts, sizeof(v));
+  return swar_at_least(v, n) == SWAR_HIGH_BITS;
+}
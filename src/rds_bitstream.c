@@ -0,0 +1,658 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <rds_decoder.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BLOCK_BITS 26                // Data (16) + checkword (10) bits.
+#define BLOCK_MASK 0x3FFFFFF         // The bits of a block.
+#define CHECK_BITS 10                // Checkword bits.
+#define SYNC_WINDOW_MASK 0x3FFFFFFFFFFFFull  // The last 50 blocks.
+#define SYNC_LOSS_ERRORS 45  // Blocks with errors (of 50) to lose sync.
+#define NUM_CANDIDATES 8     // Offset word matches remembered during search.
+#define MAX_SYNC_BLOCKS 8    // Max blocks between two matches to sync.
+#define CHASE_BITS 5         // Least reliable bits flipped by Chase decoding.
+#define NUM_CHASE_PATTERNS (1 << CHASE_BITS)
+#define SOFT_COST_1_2 32     // Max |LLR| sum of the bits flipped for BLER_1_2.
+#define SOFT_COST_3_5 64     // Max |LLR| sum of the bits flipped for BLER_3_5.
+
+/**
+ * The offset words, which are added to the checkword of each block to
+ * identify its position in the group. See RBDS spec. annex A.
+ */
+enum rds_offset {
+  OFFSET_A,
+  OFFSET_B,
+  OFFSET_C,
+  OFFSET_C_PRIME,  ///< Block C of version B groups.
+  OFFSET_D,
+  NUM_OFFSETS
+};
+
+static const uint16_t kOffsetWords[NUM_OFFSETS] = {0x0FC, 0x198, 0x168, 0x350,
+                                                   0x1B4};
+
+/// The position in the group (A = 0 .. D = 3) of the block with each offset.
+static const uint8_t kOffsetBlock[NUM_OFFSETS] = {0, 1, 2, 2, 3};
+
+// clang-format off
+
+/*
+ * The syndrome of a block is its remainder when divided by the generator
+ * polynomial g(x) = x^10 + x^8 + x^7 + x^5 + x^4 + x^3 + 1. For a block
+ * received without errors this is its offset word.
+ *
+ * The syndrome is linear, so it is computed a byte at a time: kSyndrome8[b]
+ * is the syndrome of b << 8, and so on. The low byte is its own syndrome.
+ */
+static const uint16_t kSyndrome8[256] = {
+    0x000, 0x100, 0x200, 0x300, 0x1b9, 0x0b9, 0x3b9, 0x2b9,
+    0x372, 0x272, 0x172, 0x072, 0x2cb, 0x3cb, 0x0cb, 0x1cb,
+    0x35d, 0x25d, 0x15d, 0x05d, 0x2e4, 0x3e4, 0x0e4, 0x1e4,
+    0x02f, 0x12f, 0x22f, 0x32f, 0x196, 0x096, 0x396, 0x296,
+    0x303, 0x203, 0x103, 0x003, 0x2ba, 0x3ba, 0x0ba, 0x1ba,
+    0x071, 0x171, 0x271, 0x371, 0x1c8, 0x0c8, 0x3c8, 0x2c8,
+    0x05e, 0x15e, 0x25e, 0x35e, 0x1e7, 0x0e7, 0x3e7, 0x2e7,
+    0x32c, 0x22c, 0x12c, 0x02c, 0x295, 0x395, 0x095, 0x195,
+    0x3bf, 0x2bf, 0x1bf, 0x0bf, 0x206, 0x306, 0x006, 0x106,
+    0x0cd, 0x1cd, 0x2cd, 0x3cd, 0x174, 0x074, 0x374, 0x274,
+    0x0e2, 0x1e2, 0x2e2, 0x3e2, 0x15b, 0x05b, 0x35b, 0x25b,
+    0x390, 0x290, 0x190, 0x090, 0x229, 0x329, 0x029, 0x129,
+    0x0bc, 0x1bc, 0x2bc, 0x3bc, 0x105, 0x005, 0x305, 0x205,
+    0x3ce, 0x2ce, 0x1ce, 0x0ce, 0x277, 0x377, 0x077, 0x177,
+    0x3e1, 0x2e1, 0x1e1, 0x0e1, 0x258, 0x358, 0x058, 0x158,
+    0x093, 0x193, 0x293, 0x393, 0x12a, 0x02a, 0x32a, 0x22a,
+    0x2c7, 0x3c7, 0x0c7, 0x1c7, 0x37e, 0x27e, 0x17e, 0x07e,
+    0x1b5, 0x0b5, 0x3b5, 0x2b5, 0x00c, 0x10c, 0x20c, 0x30c,
+    0x19a, 0x09a, 0x39a, 0x29a, 0x023, 0x123, 0x223, 0x323,
+    0x2e8, 0x3e8, 0x0e8, 0x1e8, 0x351, 0x251, 0x151, 0x051,
+    0x1c4, 0x0c4, 0x3c4, 0x2c4, 0x07d, 0x17d, 0x27d, 0x37d,
+    0x2b6, 0x3b6, 0x0b6, 0x1b6, 0x30f, 0x20f, 0x10f, 0x00f,
+    0x299, 0x399, 0x099, 0x199, 0x320, 0x220, 0x120, 0x020,
+    0x1eb, 0x0eb, 0x3eb, 0x2eb, 0x052, 0x152, 0x252, 0x352,
+    0x178, 0x078, 0x378, 0x278, 0x0c1, 0x1c1, 0x2c1, 0x3c1,
+    0x20a, 0x30a, 0x00a, 0x10a, 0x3b3, 0x2b3, 0x1b3, 0x0b3,
+    0x225, 0x325, 0x025, 0x125, 0x39c, 0x29c, 0x19c, 0x09c,
+    0x157, 0x057, 0x357, 0x257, 0x0ee, 0x1ee, 0x2ee, 0x3ee,
+    0x27b, 0x37b, 0x07b, 0x17b, 0x3c2, 0x2c2, 0x1c2, 0x0c2,
+    0x109, 0x009, 0x309, 0x209, 0x0b0, 0x1b0, 0x2b0, 0x3b0,
+    0x126, 0x026, 0x326, 0x226, 0x09f, 0x19f, 0x29f, 0x39f,
+    0x254, 0x354, 0x054, 0x154, 0x3ed, 0x2ed, 0x1ed, 0x0ed,
+};
+
+static const uint16_t kSyndrome16[256] = {
+    0x000, 0x037, 0x06e, 0x059, 0x0dc, 0x0eb, 0x0b2, 0x085,
+    0x1b8, 0x18f, 0x1d6, 0x1e1, 0x164, 0x153, 0x10a, 0x13d,
+    0x370, 0x347, 0x31e, 0x329, 0x3ac, 0x39b, 0x3c2, 0x3f5,
+    0x2c8, 0x2ff, 0x2a6, 0x291, 0x214, 0x223, 0x27a, 0x24d,
+    0x359, 0x36e, 0x337, 0x300, 0x385, 0x3b2, 0x3eb, 0x3dc,
+    0x2e1, 0x2d6, 0x28f, 0x2b8, 0x23d, 0x20a, 0x253, 0x264,
+    0x029, 0x01e, 0x047, 0x070, 0x0f5, 0x0c2, 0x09b, 0x0ac,
+    0x191, 0x1a6, 0x1ff, 0x1c8, 0x14d, 0x17a, 0x123, 0x114,
+    0x30b, 0x33c, 0x365, 0x352, 0x3d7, 0x3e0, 0x3b9, 0x38e,
+    0x2b3, 0x284, 0x2dd, 0x2ea, 0x26f, 0x258, 0x201, 0x236,
+    0x07b, 0x04c, 0x015, 0x022, 0x0a7, 0x090, 0x0c9, 0x0fe,
+    0x1c3, 0x1f4, 0x1ad, 0x19a, 0x11f, 0x128, 0x171, 0x146,
+    0x052, 0x065, 0x03c, 0x00b, 0x08e, 0x0b9, 0x0e0, 0x0d7,
+    0x1ea, 0x1dd, 0x184, 0x1b3, 0x136, 0x101, 0x158, 0x16f,
+    0x322, 0x315, 0x34c, 0x37b, 0x3fe, 0x3c9, 0x390, 0x3a7,
+    0x29a, 0x2ad, 0x2f4, 0x2c3, 0x246, 0x271, 0x228, 0x21f,
+    0x3af, 0x398, 0x3c1, 0x3f6, 0x373, 0x344, 0x31d, 0x32a,
+    0x217, 0x220, 0x279, 0x24e, 0x2cb, 0x2fc, 0x2a5, 0x292,
+    0x0df, 0x0e8, 0x0b1, 0x086, 0x003, 0x034, 0x06d, 0x05a,
+    0x167, 0x150, 0x109, 0x13e, 0x1bb, 0x18c, 0x1d5, 0x1e2,
+    0x0f6, 0x0c1, 0x098, 0x0af, 0x02a, 0x01d, 0x044, 0x073,
+    0x14e, 0x179, 0x120, 0x117, 0x192, 0x1a5, 0x1fc, 0x1cb,
+    0x386, 0x3b1, 0x3e8, 0x3df, 0x35a, 0x36d, 0x334, 0x303,
+    0x23e, 0x209, 0x250, 0x267, 0x2e2, 0x2d5, 0x28c, 0x2bb,
+    0x0a4, 0x093, 0x0ca, 0x0fd, 0x078, 0x04f, 0x016, 0x021,
+    0x11c, 0x12b, 0x172, 0x145, 0x1c0, 0x1f7, 0x1ae, 0x199,
+    0x3d4, 0x3e3, 0x3ba, 0x38d, 0x308, 0x33f, 0x366, 0x351,
+    0x26c, 0x25b, 0x202, 0x235, 0x2b0, 0x287, 0x2de, 0x2e9,
+    0x3fd, 0x3ca, 0x393, 0x3a4, 0x321, 0x316, 0x34f, 0x378,
+    0x245, 0x272, 0x22b, 0x21c, 0x299, 0x2ae, 0x2f7, 0x2c0,
+    0x08d, 0x0ba, 0x0e3, 0x0d4, 0x051, 0x066, 0x03f, 0x008,
+    0x135, 0x102, 0x15b, 0x16c, 0x1e9, 0x1de, 0x187, 0x1b0,
+};
+
+static const uint16_t kSyndrome24[4] = {
+    0x000, 0x2e7, 0x077, 0x290,
+};
+
+/*
+ * The burst error, if any, with each error syndrome (a block's syndrome XOR
+ * its expected offset word). The code corrects any burst of up to five bits.
+ * Each entry is (first bit << 5) | (the burst's bits), or zero if no such
+ * burst has that syndrome.
+ */
+static const uint16_t kBurstErrors[1024] = {
+    0x000, 0x001, 0x021, 0x003, 0x041, 0x005, 0x023, 0x007,
+    0x061, 0x009, 0x025, 0x00b, 0x043, 0x00d, 0x027, 0x00f,
+    0x081, 0x011, 0x029, 0x013, 0x045, 0x015, 0x02b, 0x017,
+    0x063, 0x019, 0x02d, 0x01b, 0x047, 0x01d, 0x02f, 0x01f,
+    0x0a1, 0x000, 0x031, 0x000, 0x049, 0x2b3, 0x033, 0x000,
+    0x065, 0x283, 0x035, 0x000, 0x04b, 0x000, 0x037, 0x163,
+    0x083, 0x000, 0x039, 0x000, 0x04d, 0x000, 0x03b, 0x201,
+    0x067, 0x0eb, 0x03d, 0x000, 0x04f, 0x000, 0x03f, 0x000,
+    0x0c1, 0x000, 0x000, 0x000, 0x051, 0x000, 0x000, 0x239,
+    0x069, 0x000, 0x000, 0x0fd, 0x053, 0x000, 0x000, 0x000,
+    0x085, 0x000, 0x2a3, 0x000, 0x055, 0x000, 0x000, 0x000,
+    0x06b, 0x203, 0x000, 0x000, 0x057, 0x113, 0x183, 0x000,
+    0x0a3, 0x000, 0x000, 0x000, 0x059, 0x000, 0x000, 0x000,
+    0x06d, 0x193, 0x000, 0x000, 0x05b, 0x000, 0x221, 0x000,
+    0x087, 0x165, 0x10b, 0x000, 0x05d, 0x000, 0x000, 0x321,
+    0x06f, 0x0d7, 0x000, 0x285, 0x05f, 0x000, 0x000, 0x000,
+    0x0e1, 0x2b5, 0x000, 0x000, 0x000, 0x207, 0x000, 0x000,
+    0x071, 0x000, 0x000, 0x1ab, 0x000, 0x28f, 0x259, 0x000,
+    0x089, 0x000, 0x000, 0x16f, 0x000, 0x13f, 0x11d, 0x000,
+    0x073, 0x000, 0x000, 0x23b, 0x000, 0x000, 0x000, 0x000,
+    0x0a5, 0x000, 0x000, 0x000, 0x2c3, 0x000, 0x000, 0x255,
+    0x075, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x08b, 0x000, 0x223, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x077, 0x105, 0x133, 0x000, 0x1a3, 0x000, 0x000, 0x000,
+    0x0c3, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x079, 0x000, 0x000, 0x127, 0x000, 0x169, 0x000, 0x000,
+    0x08d, 0x000, 0x1b3, 0x2cb, 0x000, 0x195, 0x000, 0x000,
+    0x07b, 0x000, 0x000, 0x000, 0x241, 0x000, 0x000, 0x289,
+    0x0a7, 0x000, 0x185, 0x000, 0x12b, 0x1bb, 0x000, 0x000,
+    0x07d, 0x000, 0x000, 0x205, 0x000, 0x000, 0x000, 0x000,
+    0x08f, 0x000, 0x0f7, 0x000, 0x000, 0x24d, 0x2a5, 0x000,
+    0x07f, 0x0d5, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x101, 0x000, 0x000, 0x131, 0x000, 0x159, 0x000, 0x000,
+    0x000, 0x17d, 0x227, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x091, 0x19f, 0x000, 0x000, 0x000, 0x000, 0x1cb, 0x000,
+    0x000, 0x000, 0x2af, 0x000, 0x279, 0x000, 0x000, 0x257,
+    0x0a9, 0x1cf, 0x000, 0x23f, 0x000, 0x000, 0x18f, 0x000,
+    0x000, 0x000, 0x15f, 0x000, 0x13d, 0x000, 0x000, 0x119,
+    0x093, 0x000, 0x000, 0x29d, 0x000, 0x27f, 0x25b, 0x000,
+    0x000, 0x0e9, 0x000, 0x000, 0x000, 0x20f, 0x000, 0x2e7,
+    0x0c5, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x2e3, 0x000, 0x000, 0x0ff, 0x000, 0x24f, 0x275, 0x1c7,
+    0x095, 0x000, 0x000, 0x20d, 0x000, 0x000, 0x000, 0x17b,
+    0x000, 0x000, 0x000, 0x155, 0x000, 0x129, 0x000, 0x000,
+    0x0ab, 0x29b, 0x000, 0x000, 0x243, 0x000, 0x000, 0x273,
+    0x000, 0x000, 0x000, 0x000, 0x000, 0x2bf, 0x000, 0x000,
+    0x097, 0x000, 0x125, 0x000, 0x153, 0x000, 0x000, 0x000,
+    0x1c3, 0x0d3, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x0e3, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x209,
+    0x099, 0x267, 0x000, 0x1d7, 0x000, 0x000, 0x147, 0x291,
+    0x000, 0x000, 0x189, 0x2cd, 0x000, 0x1bd, 0x000, 0x000,
+    0x0ad, 0x000, 0x000, 0x000, 0x1d3, 0x000, 0x000, 0x000,
+    0x000, 0x000, 0x1b5, 0x000, 0x000, 0x199, 0x000, 0x000,
+    0x09b, 0x000, 0x000, 0x000, 0x000, 0x171, 0x000, 0x000,
+    0x261, 0x141, 0x000, 0x000, 0x000, 0x000, 0x2a9, 0x000,
+    0x0c7, 0x000, 0x000, 0x26b, 0x1a5, 0x297, 0x000, 0x000,
+    0x14b, 0x2b9, 0x1db, 0x10f, 0x000, 0x000, 0x000, 0x000,
+    0x09d, 0x000, 0x000, 0x000, 0x000, 0x000, 0x225, 0x000,
+    0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x0af, 0x20b, 0x000, 0x000, 0x117, 0x000, 0x000, 0x14d,
+    0x000, 0x000, 0x26d, 0x177, 0x2c5, 0x000, 0x000, 0x000,
+    0x09f, 0x000, 0x0f5, 0x1ad, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x0d1, 0x000, 0x000, 0x000, 0x1df, 0x000, 0x23d,
+    0x121, 0x000, 0x000, 0x000, 0x000, 0x000, 0x151, 0x000,
+    0x000, 0x000, 0x179, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x2ad, 0x19d, 0x000, 0x247, 0x1b7, 0x000, 0x271,
+    0x000, 0x000, 0x000, 0x1e9, 0x000, 0x000, 0x000, 0x000,
+    0x0b1, 0x000, 0x1bf, 0x21d, 0x000, 0x18d, 0x000, 0x000,
+    0x000, 0x157, 0x000, 0x000, 0x1eb, 0x000, 0x000, 0x12d,
+    0x000, 0x000, 0x000, 0x000, 0x2cf, 0x000, 0x000, 0x000,
+    0x299, 0x0ef, 0x000, 0x000, 0x000, 0x24b, 0x277, 0x000,
+    0x0c9, 0x000, 0x1ef, 0x2c7, 0x000, 0x27d, 0x25f, 0x000,
+    0x000, 0x000, 0x000, 0x0f9, 0x1af, 0x21f, 0x000, 0x000,
+    0x000, 0x000, 0x000, 0x237, 0x17f, 0x000, 0x000, 0x000,
+    0x15d, 0x000, 0x000, 0x000, 0x000, 0x111, 0x139, 0x000,
+    0x0b3, 0x000, 0x000, 0x000, 0x000, 0x000, 0x2bd, 0x000,
+    0x000, 0x000, 0x29f, 0x000, 0x27b, 0x000, 0x000, 0x253,
+    0x000, 0x135, 0x109, 0x000, 0x000, 0x1ed, 0x000, 0x15b,
+    0x000, 0x0df, 0x22f, 0x1a7, 0x000, 0x000, 0x000, 0x000,
+    0x0e5, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x235,
+    0x303, 0x21b, 0x000, 0x000, 0x000, 0x14f, 0x11f, 0x000,
+    0x000, 0x18b, 0x26f, 0x000, 0x295, 0x000, 0x1e7, 0x000,
+    0x0b5, 0x000, 0x000, 0x000, 0x000, 0x000, 0x22d, 0x000,
+    0x000, 0x1e5, 0x000, 0x000, 0x000, 0x000, 0x19b, 0x000,
+    0x000, 0x000, 0x000, 0x269, 0x000, 0x2ab, 0x175, 0x000,
+    0x000, 0x107, 0x149, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x0cb, 0x000, 0x2bb, 0x000, 0x000, 0x000, 0x000, 0x1e1,
+    0x263, 0x000, 0x000, 0x143, 0x000, 0x000, 0x293, 0x000,
+    0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x0b7, 0x265, 0x000, 0x000, 0x145, 0x000, 0x000, 0x301,
+    0x173, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x1e3, 0x000, 0x0f3, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x0dd, 0x000, 0x000, 0x000, 0x000, 0x000, 0x219,
+    0x103, 0x000, 0x000, 0x1a1, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x000, 0x000, 0x2c1, 0x000, 0x1d9, 0x000, 0x000,
+    0x000, 0x1f5, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x229, 0x000,
+    0x0b9, 0x000, 0x287, 0x000, 0x000, 0x000, 0x1f7, 0x000,
+    0x000, 0x213, 0x000, 0x000, 0x167, 0x000, 0x2b1, 0x11b,
+    0x000, 0x000, 0x000, 0x000, 0x1a9, 0x000, 0x000, 0x231,
+    0x000, 0x0ed, 0x1dd, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x0cd, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x211,
+    0x1f3, 0x000, 0x000, 0x0fb, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x000, 0x000, 0x000, 0x1d5, 0x000, 0x000, 0x000,
+    0x000, 0x2a1, 0x1b9, 0x000, 0x000, 0x181, 0x000, 0x000,
+    0x0bb, 0x000, 0x000, 0x1d1, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x000, 0x191, 0x000, 0x000, 0x1b1, 0x000, 0x000,
+    0x281, 0x000, 0x161, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x0db, 0x000, 0x000, 0x2c9, 0x000, 0x000, 0x1f1,
+    0x0e7, 0x000, 0x000, 0x000, 0x000, 0x249, 0x28b, 0x000,
+    0x1c5, 0x000, 0x2b7, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x16b, 0x000, 0x000, 0x000, 0x1fb, 0x000, 0x12f, 0x000,
+    0x000, 0x000, 0x000, 0x215, 0x000, 0x000, 0x000, 0x000,
+    0x0bd, 0x000, 0x000, 0x1f9, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x000, 0x000, 0x000, 0x245, 0x000, 0x000, 0x2e1,
+    0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x123, 0x000, 0x000, 0x000, 0x000, 0x000, 0x1c1,
+    0x0cf, 0x000, 0x22b, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x137, 0x000, 0x000, 0x10d, 0x000, 0x1fd, 0x16d, 0x000,
+    0x000, 0x1c9, 0x000, 0x000, 0x28d, 0x000, 0x197, 0x251,
+    0x2e5, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000,
+    0x0bf, 0x187, 0x000, 0x000, 0x115, 0x000, 0x1cd, 0x13b,
+    0x000, 0x000, 0x000, 0x233, 0x000, 0x000, 0x000, 0x000,
+    0x000, 0x000, 0x0f1, 0x000, 0x000, 0x217, 0x000, 0x000,
+    0x000, 0x0d9, 0x1ff, 0x000, 0x000, 0x2a7, 0x25d, 0x000,
+};
+
+// clang-format on
+
+/**
+ * A match of an offset word found while searching for synchronization.
+ */
+struct sync_candidate {
+  uint32_t bit;   ///< The bit count when the block ended.
+  uint8_t block;  ///< The position in the group of the matched offset.
+};
+
+struct rds_bitstream {
+  struct rds_bitstream_config config;
+  struct rds_bitstream_stats stats;
+  uint32_t reg;        ///< The last 26 bits received, newest in bit 0.
+  uint32_t bit_count;  ///< Bits received (wraps, only differences matter).
+  bool synced;         ///< Are block boundaries known?
+
+  // Used when synchronized:
+  uint8_t block_bits;      ///< Bits of the current block received.
+  uint8_t next_block;      ///< Position in the group of the current block.
+  uint64_t error_history;  ///< One bit per block, set if it had errors.
+  struct rds_blocks group;  ///< The group being received.
+  uint8_t soft_bits;        ///< Soft decision bits in the current block.
+  uint8_t reliability[BLOCK_BITS];  ///< |LLR| of each bit, first received
+                                    ///< first.
+
+  // Used when searching:
+  struct sync_candidate candidates[NUM_CANDIDATES];
+  uint8_t num_candidates;
+  uint8_t next_candidate;
+};
+
+/**
+ * Return the syndrome of a 26 bit block.
+ */
+static uint16_t syndrome(uint32_t block) {
+  return (block & 0xFF) ^ kSyndrome8[(block >> 8) & 0xFF] ^
+         kSyndrome16[(block >> 16) & 0xFF] ^ kSyndrome24[block >> 24];
+}
+
+/**
+ * Return the block error count (See BLER_*) of a corrected burst.
+ */
+static uint8_t burst_bler(uint8_t burst) {
+  return __builtin_popcount(burst) <= 2 ? BLER_1_2 : BLER_3_5;
+}
+
+/**
+ * Decode the data of a block, correcting a burst error if possible.
+ *
+ * @param block The received block.
+ * @param pos   The expected position of the block in the group.
+ * @param out   Set to the (corrected) data and block error count.
+ */
+static void decode_block(uint32_t block, uint8_t pos, struct rds_block* out) {
+  const uint16_t s = syndrome(block);
+  out->val = block >> CHECK_BITS;
+  out->errors = BLER_6_PLUS;
+  for (uint8_t i = 0; i < NUM_OFFSETS; i++) {
+    if (kOffsetBlock[i] != pos)
+      continue;
+    if (s == kOffsetWords[i]) {
+      out->val = block >> CHECK_BITS;
+      out->errors = BLER_NONE;
+      return;
+    }
+    const uint16_t burst = kBurstErrors[s ^ kOffsetWords[i]];
+    if (!burst)
+      continue;
+    const uint8_t bits = burst & 0x1F;
+    const uint8_t errors = burst_bler(bits);
+    if (errors < out->errors) {
+      out->val = (block ^ ((uint32_t)bits << (burst >> 5))) >> CHECK_BITS;
+      out->errors = errors;
+    }
+  }
+}
+
+/**
+ * Return the block error count (See BLER_*) of a soft decision correction.
+ *
+ * This is based on how confident the demodulator was in the flipped bits,
+ * rather than on how many there were, so a block whose only errors are in
+ * marginal bits can still be used.
+ */
+static uint8_t soft_bler(uint32_t cost) {
+  if (cost <= SOFT_COST_1_2)
+    return BLER_1_2;
+  return cost <= SOFT_COST_3_5 ? BLER_3_5 : BLER_6_PLUS;
+}
+
+/**
+ * Return the sum of the reliabilities of the bits set in \p flips.
+ */
+static uint32_t flip_cost(uint32_t flips, const uint8_t* reliability) {
+  uint32_t cost = 0;
+  for (; flips; flips &= flips - 1)
+    cost += reliability[BLOCK_BITS - 1 - __builtin_ctz(flips)];
+  return cost;
+}
+
+/**
+ * Decode a block using soft decisions (Chase decoding).
+ *
+ * Every combination of the CHASE_BITS least reliable bits is flipped, each
+ * test pattern is decoded as a hard decision block (correcting a burst if
+ * possible), and the valid block which needed the least confident bits
+ * flipped is chosen. The syndrome of each pattern is the XOR of the
+ * syndromes of its bits, so each costs only a table lookup.
+ *
+ * @param block       The received block (hard decisions).
+ * @param pos         The expected position of the block in the group.
+ * @param reliability The |LLR| of each bit of the block.
+ * @param out         Set to the decoded data and block error count.
+ */
+static void chase_decode_block(uint32_t block,
+                               uint8_t pos,
+                               const uint8_t* reliability,
+                               struct rds_block* out) {
+  // The least reliable bits, as masks of the block.
+  uint32_t weakest[CHASE_BITS];
+  uint8_t weakest_llr[CHASE_BITS];
+  uint8_t num_weakest = 0;
+  for (uint8_t i = 0; i < BLOCK_BITS; i++) {
+    uint8_t j = num_weakest < CHASE_BITS ? num_weakest++ : CHASE_BITS;
+    for (; j > 0 && weakest_llr[j - 1] > reliability[i]; j--) {
+      if (j < CHASE_BITS) {
+        weakest[j] = weakest[j - 1];
+        weakest_llr[j] = weakest_llr[j - 1];
+      }
+    }
+    if (j < CHASE_BITS) {
+      weakest[j] = 1u << (BLOCK_BITS - 1 - i);
+      weakest_llr[j] = reliability[i];
+    }
+  }
+
+  uint32_t pattern_flips[NUM_CHASE_PATTERNS];
+  uint16_t pattern_syndromes[NUM_CHASE_PATTERNS];
+  pattern_flips[0] = 0;
+  pattern_syndromes[0] = syndrome(block);
+
+  uint32_t best_cost = UINT32_MAX;
+  uint32_t best_flips = 0;
+  for (uint8_t p = 0; p < NUM_CHASE_PATTERNS; p++) {
+    if (p) {
+      const uint8_t prev = p & (p - 1);
+      const uint32_t flip = weakest[__builtin_ctz(p)];
+      pattern_flips[p] = pattern_flips[prev] | flip;
+      pattern_syndromes[p] = pattern_syndromes[prev] ^ syndrome(flip);
+    }
+    for (uint8_t i = 0; i < NUM_OFFSETS; i++) {
+      if (kOffsetBlock[i] != pos)
+        continue;
+      const uint16_t error = pattern_syndromes[p] ^ kOffsetWords[i];
+      uint32_t flips = pattern_flips[p];
+      if (error) {
+        const uint16_t burst = kBurstErrors[error];
+        if (!burst)
+          continue;
+        flips ^= (uint32_t)(burst & 0x1F) << (burst >> 5);
+      }
+      const uint32_t cost = flip_cost(flips, reliability);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_flips = flips;
+      }
+    }
+  }
+
+  if (best_cost == UINT32_MAX) {
+    out->val = block >> CHECK_BITS;
+    out->errors = BLER_6_PLUS;
+    return;
+  }
+  out->val = (block ^ best_flips) >> CHECK_BITS;
+  out->errors = soft_bler(best_cost);
+}
+
+/**
+ * Start receiving a new group, with all blocks missing.
+ */
+static void clear_group(struct rds_blocks* group) {
+  static const struct rds_block kMissing = {0, BLER_6_PLUS};
+  group->a = kMissing;
+  group->b = kMissing;
+  group->c = kMissing;
+  group->d = kMissing;
+}
+
+static struct rds_block* group_block(struct rds_blocks* group, uint8_t pos) {
+  switch (pos) {
+    case 0:
+      return &group->a;
+    case 1:
+      return &group->b;
+    case 2:
+      return &group->c;
+    default:
+      return &group->d;
+  }
+}
+
+/**
+ * Store a received block, and pass on the group once it is complete.
+ */
+static void store_block(struct rds_bitstream* bs,
+                        uint8_t pos,
+                        const struct rds_block* block) {
+  *group_block(&bs->group, pos) = *block;
+  bs->next_block = (pos + 1) & 3;
+  if (pos != 3)
+    return;
+  bs->stats.groups++;
+  if (bs->config.group_cb)
+    bs->config.group_cb(&bs->group, bs->config.cb_data);
+  clear_group(&bs->group);
+}
+
+static void lose_sync(struct rds_bitstream* bs) {
+  bs->synced = false;
+  bs->num_candidates = 0;
+  bs->stats.sync_losses++;
+}
+
+/**
+ * Receive a block when synchronized.
+ */
+static void receive_block(struct rds_bitstream* bs) {
+  const uint8_t pos = bs->next_block;
+  struct rds_block block;
+  decode_block(bs->reg, pos, &block);
+  if (block.errors != BLER_NONE && bs->soft_bits == BLOCK_BITS) {
+    struct rds_block soft;
+    chase_decode_block(bs->reg, pos, bs->reliability, &soft);
+    if (soft.errors < block.errors)
+      bs->stats.soft_corrected_blocks++;
+    if (soft.errors <= block.errors)
+      block = soft;
+  }
+  bs->soft_bits = 0;
+
+  bs->stats.blocks++;
+  if (block.errors == BLER_6_PLUS)
+    bs->stats.uncorrectable_blocks++;
+  else if (block.errors != BLER_NONE)
+    bs->stats.corrected_blocks++;
+  bs->error_history = (bs->error_history << 1) | (block.errors != BLER_NONE);
+
+  store_block(bs, pos, &block);
+
+  // Flywheel: stay synchronized through bursts of noise, and only give up
+  // when nearly every recent block has errors. Corrected blocks count too,
+  // as after a bit slip many garbled blocks look like correctable bursts.
+  if (__builtin_popcountll(bs->error_history & SYNC_WINDOW_MASK) >
+      SYNC_LOSS_ERRORS) {
+    lose_sync(bs);
+  }
+}
+
+/**
+ * Look for a block boundary at the current bit.
+ *
+ * Synchronization is acquired when two offset words are found a whole
+ * number of blocks apart, in the order they would be sent.
+ */
+static void search(struct rds_bitstream* bs) {
+  const uint16_t s = syndrome(bs->reg);
+  uint8_t offset = 0;
+  while (offset < NUM_OFFSETS && s != kOffsetWords[offset])
+    offset++;
+  if (offset == NUM_OFFSETS)
+    return;
+
+  const uint8_t pos = kOffsetBlock[offset];
+  for (uint8_t i = 0; i < bs->num_candidates; i++) {
+    const struct sync_candidate* c = &bs->candidates[i];
+    const uint32_t dist = bs->bit_count - c->bit;
+    if (dist % BLOCK_BITS || dist > MAX_SYNC_BLOCKS * BLOCK_BITS)
+      continue;
+    if (((c->block + dist / BLOCK_BITS) & 3) != pos)
+      continue;
+
+    bs->synced = true;
+    bs->block_bits = 0;
+    bs->soft_bits = 0;
+    bs->error_history = 0;
+    bs->stats.syncs++;
+    clear_group(&bs->group);
+    const struct rds_block block = {(uint16_t)(bs->reg >> CHECK_BITS),
+                                    BLER_NONE};
+    bs->stats.blocks++;
+    store_block(bs, pos, &block);
+    return;
+  }
+
+  struct sync_candidate* c = &bs->candidates[bs->next_candidate];
+  c->bit = bs->bit_count;
+  c->block = pos;
+  bs->next_candidate = (bs->next_candidate + 1) % NUM_CANDIDATES;
+  if (bs->num_candidates < NUM_CANDIDATES)
+    bs->num_candidates++;
+}
+
+/******************************************/
+/*vvvvvvvvvv EXPORTED FUNCTIONS *vvvvvvvvv*/
+/******************************************/
+
+struct rds_bitstream* rds_bitstream_create(
+    const struct rds_bitstream_config* config) {
+  struct rds_bitstream* bs =
+      (struct rds_bitstream*)malloc(sizeof(struct rds_bitstream));
+  if (!bs)
+    return NULL;
+  bs->config = *config;
+  rds_bitstream_reset(bs);
+  return bs;
+}
+
+void rds_bitstream_delete(struct rds_bitstream* bs) {
+  free(bs);
+}
+
+void rds_bitstream_reset(struct rds_bitstream* bs) {
+  const struct rds_bitstream_config config = bs->config;
+  memset(bs, 0, sizeof(*bs));
+  bs->config = config;
+  clear_group(&bs->group);
+}
+
+void rds_bitstream_push_bit(struct rds_bitstream* bs, bool bit) {
+  bs->reg = ((bs->reg << 1) | bit) & BLOCK_MASK;
+  bs->bit_count++;
+  bs->stats.bits++;
+  if (!bs->synced) {
+    search(bs);
+  } else if (++bs->block_bits == BLOCK_BITS) {
+    bs->block_bits = 0;
+    receive_block(bs);
+  }
+}
+
+void rds_bitstream_push_bits(struct rds_bitstream* bs,
+                             const uint8_t* data,
+                             size_t num_bits) {
+  size_t i = 0;
+  while (i < num_bits) {
+    // When synchronized, whole bytes which don't complete a block can be
+    // shifted in at once, as only complete blocks are examined.
+    if (bs->synced && !(i & 7) && num_bits - i >= 8 &&
+        bs->block_bits + 8 < BLOCK_BITS) {
+      bs->reg = ((bs->reg << 8) | data[i >> 3]) & BLOCK_MASK;
+      bs->bit_count += 8;
+      bs->stats.bits += 8;
+      bs->block_bits += 8;
+      i += 8;
+      continue;
+    }
+    rds_bitstream_push_bit(bs, (data[i >> 3] >> (7 - (i & 7))) & 1);
+    i++;
+  }
+}
+
+void rds_bitstream_push_soft_bits(struct rds_bitstream* bs,
+                                  const int8_t* llrs,
+                                  size_t num_bits) {
+  for (size_t i = 0; i < num_bits; i++) {
+    const int8_t llr = llrs[i];
+    if (bs->synced) {
+      bs->reliability[bs->block_bits] =
+          llr >= 0 ? llr : (llr == INT8_MIN ? INT8_MAX : -llr);
+      bs->soft_bits++;
+    }
+    rds_bitstream_push_bit(bs, llr > 0);
+  }
+}
+
+bool rds_bitstream_synced(const struct rds_bitstream* bs) {
+  return bs->synced;
+}
+
+const struct rds_bitstream_stats* rds_bitstream_get_stats(
+    const struct rds_bitstream* bs) {
+  return &bs->stats;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <rds_decoder.h>
+
+#include <stdlib.h>
+
+/**
+ * A single-producer/single-consumer ring of groups.
+ *
+ * head and tail are free running counts of the groups read and written.
+ * Each is only written by one side, so no read-modify-write atomics (which
+ * may be unavailable in interrupt handlers) are needed.
+ */
+struct rds_block_ring {
+  uint32_t head;     ///< Groups read. Written by the consumer.
+  uint32_t tail;     ///< Groups written. Written by the producer.
+  uint32_t dropped;  ///< Groups dropped. Written by the producer.
+  uint32_t mask;     ///< The capacity - 1.
+  struct rds_blocks groups[];
+};
+
+struct rds_block_ring* rds_block_ring_create(uint16_t capacity) {
+  if (!capacity || (capacity & (capacity - 1)))
+    return NULL;  // Not a power of two.
+  struct rds_block_ring* ring = (struct rds_block_ring*)calloc(
+      1, sizeof(struct rds_block_ring) + capacity * sizeof(struct rds_blocks));
+  if (ring)
+    ring->mask = capacity - 1;
+  return ring;
+}
+
+void rds_block_ring_delete(struct rds_block_ring* ring) {
+  free(ring);
+}
+
+bool rds_block_ring_push(struct rds_block_ring* ring,
+                         const struct rds_blocks* blocks) {
+  const uint32_t tail = ring->tail;
+  if (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) > ring->mask) {
+    __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+    return false;
+  }
+  ring->groups[tail & ring->mask] = *blocks;
+  __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+size_t rds_block_ring_drain(struct rds_block_ring* ring,
+                            struct rds_decoder* decoder) {
+  const uint32_t head = ring->head;
+  const uint32_t count = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) - head;
+  if (!count)
+    return 0;
+
+  // The pending groups are in at most two contiguous runs.
+  const uint32_t start = head & ring->mask;
+  const uint32_t first = count < ring->mask + 1 - start
+                             ? count
+                             : ring->mask + 1 - start;
+  rds_decoder_decode_batch(decoder, &ring->groups[start], first);
+  if (count > first)
+    rds_decoder_decode_batch(decoder, &ring->groups[0], count - first);
+
+  __atomic_store_n(&ring->head, head + count, __ATOMIC_RELEASE);
+  return count;
+}
+
+size_t rds_block_ring_size(const struct rds_block_ring* ring) {
+  // Load head first: tail never falls behind an earlier head, so this can't
+  // wrap when called from a thread other than the producer and consumer.
+  // Both may move between the loads, so the size is clamped to the capacity.
+  const uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+  const uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+  const uint32_t size = tail - head;
+  return size > ring->mask ? ring->mask + 1 : size;
+}
+
+uint32_t rds_block_ring_dropped(const struct rds_block_ring* ring) {
+  return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
@@ -22,7 +22,10 @@
 
 #include "freq_table.h"
 #include "freq_table_group.h"
+#include "ps_counts.h"
+#include "rds_decoder_priv.h"
 #include "rds_misc.h"
+#include "rt_text.h"
 
 // clang-format off
 
@@ -33,30 +36,53 @@
 
 // clang-format on
 
+#define PS_VALIDATE_LIMIT 2
 #define RT_VALIDATE_LIMIT 2
+#define PREFETCH_GROUPS 8  // How far ahead rds_decoder_decode_batch prefetches.
 
-struct rds_decoder {
-  struct rds_data* rds;  ///< Decode blocks into this (not owned by lib.).
-  struct {
-    /**
-     * A pointer to a function to decode ODA block data.
-     *
-     * This can be null if the application does not intend to decode ODA data.
-     */
-    DecodeODAFunc decode_cb;
-
-    /**
-     * A pointer to a function to clear stored ODA data.
-     *
-     * This is generally called when tuning to new channels, or at other times
-     * when the RDS data is to be cleared.
-     */
-    ClearODAFunc clear_cb;
-
-    void* cb_data;            ///< User data passed to both callbacks.
-  } oda;                      ///< ODA decode callbacks.
-  bool advanced_ps_decoding;  ///< Algorithm when decoding PS text.
-};
+/**
+ * Mark a value as changed by the group being decoded.
+ */
+static void set_changed(struct rds_data* rds, enum rds_value_idx idx) {
+  SET_BITS(rds->changed_values, 1u << idx);
+}
+
+/**
+ * Mark a value as valid, and as updated by the group being decoded.
+ *
+ * A value which was not previously valid is also marked as changed.
+ */
+static void set_valid(struct rds_data* rds, enum rds_value_idx idx) {
+  if (!(rds->valid_values & (1u << idx)))
+    set_changed(rds, idx);
+  SET_BITS(rds->valid_values, 1u << idx);
+  rds->update_time[idx] = rds->timestamp;
+}
+
+/**
+ * Set a byte of a value, marking the value as changed if the byte differs.
+ */
+static void update_byte(struct rds_data* rds,
+                        enum rds_value_idx idx,
+                        uint8_t* dst,
+                        uint8_t byte) {
+  if (*dst == byte)
+    return;
+  *dst = byte;
+  set_changed(rds, idx);
+}
+
+/**
+ * Set the PI code, marking it as changed if it differs.
+ */
+static void update_pi_code(struct rds_data* rds, uint16_t pi_code) {
+  if (rds->pi_code != pi_code)
+    set_changed(rds, RDS_PI_CODE_IDX);
+  rds->pi_code = pi_code;
+  set_valid(rds, RDS_PI_CODE_IDX);
+}
+
+#if RDS_ENABLE_ODA
 
 /**
  * Are two given group types equal?
@@ -67,15 +93,94 @@ static bool GroupTypesEqual(const struct rds_group_type gta,
 }
 
 /**
- * Is the ODA data supposed to be in the given group type?
+ * Return the group type of the given blocks.
+ */
+static struct rds_group_type group_type(const struct rds_blocks* blocks) {
+  const struct rds_group_type gt = {
+      .code = (blocks->b.val & GT_CODE_MASK) >> 12,
+      .version = blocks->b.val & VERSION_CODE ? 'B' : 'A',
+  };
+  return gt;
+}
+
+#endif  // RDS_ENABLE_ODA
+
+/**
+ * Return the 5-bit group type code and version of the given blocks, which
+ * are the top five bits of block B.
+ */
+static uint8_t group_idx(const struct rds_blocks* blocks) {
+  return blocks->b.val >> 11;
+}
+
+/**
+ * Return the index of a group type in the group handler table.
+ */
+static uint8_t gt_idx(const struct rds_group_type gt) {
+  return ((gt.code & 0xf) << 1) | (gt.version == 'B' ? 1 : 0);
+}
+
+#if RDS_ENABLE_ODA
+
+/**
+ * Return the index (in rds->oda) of the ODA carried by group type \p gt, or
+ * -1 if none.
+ */
+static int find_oda_by_group_type(const struct rds_data* rds,
+                                  const struct rds_group_type gt) {
+  return (int)rds->oda_pvt.by_group[gt_idx(gt)] - 1;
+}
+
+/**
+ * Return the first slot to probe in rds->oda_pvt.by_aid for \p app_id.
+ */
+static uint8_t aid_slot(uint16_t app_id) {
+  // Fibonacci hashing: the top bits of the product are well mixed.
+  return (uint16_t)(app_id * 40503u) >> 12;
+}
+
+/**
+ * Return the index (in rds->oda) of the ODA with the given AID, or -1 if none.
  */
-static bool IsGroupTypeUsedByODA(const struct rds_data* rds,
-                                 const struct rds_group_type gt) {
-  for (size_t i = 0; i < ARRAY_SIZE(rds->oda); i++) {
-    if (GroupTypesEqual(rds->oda[i].gt, gt))
-      return true;
+static int find_oda_by_aid(const struct rds_data* rds, uint16_t app_id) {
+  const uint8_t mask = ARRAY_SIZE(rds->oda_pvt.by_aid) - 1;
+  uint8_t slot = aid_slot(app_id);
+  for (size_t i = 0; i < ARRAY_SIZE(rds->oda_pvt.by_aid); i++) {
+    const uint8_t entry = rds->oda_pvt.by_aid[slot];
+    if (entry == 0)
+      return -1;
+    if (rds->oda[entry - 1].id == app_id)
+      return entry - 1;
+    slot = (slot + 1) & mask;
   }
-  return false;
+  return -1;
+}
+
+/**
+ * Add rds->oda[idx] to the AID index.
+ */
+static void add_oda_aid(struct rds_data* rds, uint8_t idx) {
+  const uint8_t mask = ARRAY_SIZE(rds->oda_pvt.by_aid) - 1;
+  uint8_t slot = aid_slot(rds->oda[idx].id);
+  while (rds->oda_pvt.by_aid[slot] != 0)
+    slot = (slot + 1) & mask;
+  rds->oda_pvt.by_aid[slot] = idx + 1;
+}
+
+/**
+ * Update the group type index entry of \p gt after an ODA's group type
+ * changed. If several ODAs use the same group type the first is used.
+ */
+static void update_oda_group_type(struct rds_data* rds,
+                                  const struct rds_group_type gt) {
+  uint8_t entry = 0;
+  for (uint8_t idx = 0; idx < rds->oda_cnt; idx++) {
+    if (GroupTypesEqual(rds->oda[idx].gt, gt)) {
+      entry = idx + 1;
+      break;
+    }
+  }
+  rds->oda_pvt.by_group[gt_idx(gt)] = entry;
 }
 
 /**
@@ -85,20 +190,28 @@ static bool IsValidODAAppId(const uint16_t app_id) {
   return app_id != 0x0;
 }
 
+#endif  // RDS_ENABLE_ODA
+
 /**
  * Read the PTY (Program Type). Only call if BLER is acceptable.
  */
 static void decode_pty(struct rds_data* rds, const struct rds_block* block) {
-  rds->tp_code = block->val & TP_CODE;
-  rds->pty = (block->val & PTY_MASK) >> 5;
-
-  SET_BITS(rds->valid_values, RDS_TP_CODE);
+  const bool tp_code = block->val & TP_CODE;
+  const uint8_t pty = (block->val & PTY_MASK) >> 5;
+  if (rds->tp_code != tp_code)
+    set_changed(rds, RDS_TP_CODE_IDX);
+  if (rds->pty != pty)
+    set_changed(rds, RDS_PTY_IDX);
+  rds->tp_code = tp_code;
+  rds->pty = pty;
+
+  set_valid(rds, RDS_TP_CODE_IDX);
 #if defined(RDS_DEV)
   if (rds->tp_code)
     rds->stats.counts[PKTCNT_TP_CODE]++;
 #endif
 
-  SET_BITS(rds->valid_values, RDS_PTY);
+  set_valid(rds, RDS_PTY_IDX);
 #if defined(RDS_DEV)
   rds->stats.counts[PKTCNT_PTY]++;
 #endif
@@ -112,8 +225,11 @@ static void decode_ta(struct rds_data* rds, const struct rds_block* block) {
 #define TA_MASK       0b0000000000010000
   // clang-format on
 
-  rds->ta_code = block->val & TA_MASK ? true : false;
-  SET_BITS(rds->valid_values, RDS_TA_CODE);
+  const bool ta_code = block->val & TA_MASK ? true : false;
+  if (rds->ta_code != ta_code)
+    set_changed(rds, RDS_TA_CODE_IDX);
+  rds->ta_code = ta_code;
+  set_valid(rds, RDS_TA_CODE_IDX);
 #if defined(RDS_DEV)
   rds->stats.counts[PKTCNT_TA_CODE]++;
 #endif
@@ -129,13 +245,18 @@ static void decode_ms(struct rds_data* rds, const struct rds_block* block) {
 #define DIS_ADDR_MASK 0b0000000000000011
   // clang-format on
 
-  rds->music = block->val & MS_MASK ? true : false;
-  SET_BITS(rds->valid_values, RDS_MS);
+  const bool music = block->val & MS_MASK ? true : false;
+  if (rds->music != music)
+    set_changed(rds, RDS_MS_IDX);
+  rds->music = music;
+  set_valid(rds, RDS_MS_IDX);
 #if defined(RDS_DEV)
   rds->stats.counts[PKTCNT_MS]++;
 #endif
 }
 
+#if RDS_ENABLE_RT
+
 /**
  * The basic implementation of the Radiotext update.
  *
@@ -165,33 +286,22 @@ static void update_rt_simple(struct rds_rt* rt,
       if (chars[i] == 0x0d) {
         // The end of message character has been received.
         // Wipe out the rest of the text.
-        for (uint8_t j = addr + i + 1; j < ARRAY_SIZE(rt->display); j++) {
-          rt->display[j] = 0;
-        }
+        const uint8_t end = addr + i + 1;
+        memset(rt->display + end, 0, sizeof(rt->display) - end);
         break;
       }
     }
   }
 
   // Any null character before this should become a space.
-  for (i = 0; i < addr; i++) {
-    if (!rt->display[i])
-      rt->display[i] = ' ';
-  }
+  rt_fill_nulls(rt->display, addr);
 }
 
-static void bump_rt_validation_count(struct rds_rt* rt) {
-  uint8_t i;
-  for (i = 0; i < ARRAY_SIZE(rt->pvt.hi_prob_cnt); i++) {
-    if (!rt->pvt.hi_prob[i]) {
-      rt->pvt.hi_prob[i] = ' ';
-      rt->pvt.hi_prob_cnt[i]++;
-    }
-  }
-  for (i = 0; i < ARRAY_SIZE(rt->pvt.hi_prob_cnt); i++)
-    rt->pvt.hi_prob_cnt[i]++;
-
-  // Wipe out the cached text.
+/**
+ * Clear the Radiotext validation state (the cached text and hit counts), so
+ * that the text is validated again from scratch.
+ */
+static void clear_rt_validation(struct rds_rt* rt) {
   memset(rt->pvt.hi_prob_cnt, 0, sizeof(rt->pvt.hi_prob_cnt));
   memset(rt->pvt.hi_prob, 0, sizeof(rt->pvt.hi_prob));
   memset(rt->pvt.lo_prob, 0, sizeof(rt->pvt.lo_prob));
@@ -267,12 +377,11 @@ static void update_rt_advance(struct rds_rt* rt,
 
   // When the text is changing, decrement the count for all characters to
   // prevent displaying part of a message that is in transition.
-  for (i = 0; i < ARRAY_SIZE(rt->pvt.hi_prob_cnt); i++) {
-    if (rt->pvt.hi_prob_cnt[i] > 1)
-      rt->pvt.hi_prob_cnt[i]--;
-  }
+  rt_decrement_counts(rt->pvt.hi_prob_cnt, ARRAY_SIZE(rt->pvt.hi_prob_cnt));
 }
 
+#endif  // RDS_ENABLE_RT
+
 /**
  * Update the Program Service text in our buffers from the shadow registers.
  *
@@ -280,19 +389,16 @@ static void update_rt_advance(struct rds_rt* rt,
  * complete messages for stations who rotate text through the PS field in
  * violation of the RBDS standard as well as providing enhanced error detection.
  *
- * This function is from the Silicon Labs sample application.
+ * This function is from the Silicon Labs sample application. As PS is eight
+ * characters the hit counts are updated together, as one 64-bit word.
  */
 static void update_ps_advanced(struct rds_data* rds,
                                uint8_t char_idx,
                                uint8_t byte) {
-  const uint8_t PS_VALIDATE_LIMIT = 2;
-
   if (char_idx >= ARRAY_SIZE(rds->ps.display))
     return;
 
-  uint8_t i;
   bool in_transition = false;  ///< Indicates if the PS text is in transition.
-  bool complete = true;  ///< Indicates the PS text is ready to be displayed.
 
   if (rds->ps.pvt.hi_prob[char_idx] == byte) {
     // The new byte matches the high probability byte.
@@ -329,26 +435,20 @@ static void update_ps_advanced(struct rds_data* rds,
   if (in_transition) {
     // When the text is changing, decrement the count for all characters to
     // prevent displaying part of a message that is in transition.
-    for (i = 0; i < ARRAY_SIZE(rds->ps.pvt.hi_prob_cnt); i++) {
-      if (rds->ps.pvt.hi_prob_cnt[i] > 1) {
-        rds->ps.pvt.hi_prob_cnt[i]--;
-      }
-    }
+    ps_decrement_counts(rds->ps.pvt.hi_prob_cnt);
   }
 
   // The PS text is incomplete if any character in the high probability array
   // has been seen fewer times than the validation limit.
-  for (i = 0; i < ARRAY_SIZE(rds->ps.pvt.hi_prob_cnt); i++) {
-    if (rds->ps.pvt.hi_prob_cnt[i] < PS_VALIDATE_LIMIT) {
-      complete = false;
-      break;
-    }
-  }
+  rds->ps.complete =
+      ps_counts_at_least(rds->ps.pvt.hi_prob_cnt, PS_VALIDATE_LIMIT);
 
   // If the PS text in the high probability array is complete copy it to the
   // display array.
-  if (complete) {
-    SET_BITS(rds->valid_values, RDS_PS);
+  if (rds->ps.complete) {
+    if (memcmp(rds->ps.display, rds->ps.pvt.hi_prob, sizeof(rds->ps.display)))
+      set_changed(rds, RDS_PS_IDX);
+    set_valid(rds, RDS_PS_IDX);
     memcpy(rds->ps.display, rds->ps.pvt.hi_prob, sizeof(rds->ps.pvt.hi_prob));
   }
 }
@@ -363,10 +463,14 @@ static void update_ps_simple(struct rds_data* rds,
                              uint8_t current_ps_byte) {
   if (char_idx >= ARRAY_SIZE(rds->ps.display))
     return;
-  rds->ps.display[char_idx] = current_ps_byte;
-  SET_BITS(rds->valid_values, RDS_PS);
+  update_byte(rds, RDS_PS_IDX, &rds->ps.display[char_idx], current_ps_byte);
+  set_valid(rds, RDS_PS_IDX);
+  SET_BITS(rds->ps.pvt.received, 1u << char_idx);
+  rds->ps.complete = rds->ps.pvt.received == 0xFF;
 }
 
+#if RDS_ENABLE_AF
+
 /**
  * Decode alternative frequencies from group 0A IAW RDBS specification
  * section 3.2.1.6.2.
@@ -380,26 +484,22 @@ static void decode_alt_freq(struct rds_data* rds,
   if (blocks->c.errors != BLER_NONE)
     return;
 
-  SET_BITS(rds->valid_values, RDS_AF);
+  set_valid(rds, RDS_AF_IDX);
 #if defined(RDS_DEV)
   rds->stats.counts[PKTCNT_AF]++;
 #endif
 
-  decode_freq_group_block(&rds->af, blocks->c.val);
+  if (decode_freq_group_block(&rds->af, blocks->c.val))
+    set_changed(rds, RDS_AF_IDX);
 }
 
+#endif  // RDS_ENABLE_AF
+
 /**
- * Decode group type 0 data.
- *
- *  0A: Basic tuning and switching information (pt 1).
- *  0B: Basic tuning and switching information (pt 2).
+ * Decode basic tuning and switching information, common to 0A and 0B.
  */
-static void decode_group_type_0(const struct rds_decoder* decoder,
-                                const struct rds_group_type gt,
+static void decode_basic_tuning(const struct rds_decoder* decoder,
                                 const struct rds_blocks* blocks) {
-  if (gt.version == 'A')
-    decode_alt_freq(decoder->rds, blocks);
-
   if (blocks->d.errors > BLERD_MAX)
     return;
 
@@ -419,6 +519,25 @@ static void decode_group_type_0(const struct rds_decoder* decoder,
 #endif
 }
 
+/**
+ * Decode group type 0A: Basic tuning and switching information (pt 1).
+ */
+static void decode_group_0a(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+#if RDS_ENABLE_AF
+  decode_alt_freq(decoder->rds, blocks);
+#endif
+  decode_basic_tuning(decoder, blocks);
+}
+
+/**
+ * Decode group type 0B: Basic tuning and switching information (pt 2).
+ */
+static void decode_group_0b(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+  decode_basic_tuning(decoder, blocks);
+}
+
 /**
  * Decode slow labeling codes and program item number.
  *
@@ -442,11 +561,14 @@ const uint16_t C_SLC_COUNTRY_MASK = 0b0000000011111111;
   if (blocks->c.errors > BLERC_MAX)
     return;
 
-  SET_BITS(rds->valid_values, RDS_SLC);
+  set_valid(rds, RDS_SLC_IDX);
 #if defined(RDS_DEV)
   rds->stats.counts[PKTCNT_SLC]++;
 #endif
 
+  uint8_t prev_slc[sizeof(rds->slc)];
+  memcpy(prev_slc, &rds->slc, sizeof(prev_slc));
+
   rds->slc.la = (blocks->c.val & C_SLC_LA) ? true : false;
   rds->slc.variant_code =
       (enum rds_variant_code)((blocks->c.val & C_SLC_VC) >> 12);
@@ -475,6 +597,8 @@ const uint16_t C_SLC_COUNTRY_MASK = 0b0000000011111111;
       rds->slc.data.ews_channel_id = blocks->c.val & C_SLC_DATA;
       break;
   }
+  if (memcmp(prev_slc, &rds->slc, sizeof(prev_slc)))
+    set_changed(rds, RDS_SLC_IDX);
 }
 
 /**
@@ -504,20 +628,20 @@ static void decode_program_item_number_code(uint16_t raw_value,
 }
 
 /**
- * Decode group type 1 data.
- *
- *  1A: Program Item Number and slow labeling codes.
- *  1B: Program Item Number.
+ * Decode group type 1B: Program Item Number.
  */
-static void decode_group_type_1(const struct rds_decoder* decoder,
-                                const struct rds_group_type gt,
-                                const struct rds_blocks* blocks) {
-  if (gt.version == 'A')
-    decode_slow_labelling_codes(decoder->rds, blocks);
-
+static void decode_group_1b(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
   if (blocks->d.errors <= BLERD_MAX) {
-    decode_program_item_number_code(blocks->d.val, &decoder->rds->pic);
-    SET_BITS(decoder->rds->valid_values, RDS_PIC);
+    struct rds_pic pic;
+    decode_program_item_number_code(blocks->d.val, &pic);
+    if (pic.day != decoder->rds->pic.day ||
+        pic.hour != decoder->rds->pic.hour ||
+        pic.minute != decoder->rds->pic.minute) {
+      set_changed(decoder->rds, RDS_PIC_IDX);
+    }
+    decoder->rds->pic = pic;
+    set_valid(decoder->rds, RDS_PIC_IDX);
 #if defined(RDS_DEV)
     decoder->rds->stats.counts[PKTCNT_PIC]++;
 #endif
@@ -525,138 +649,212 @@ static void decode_group_type_1(const struct rds_decoder* decoder,
 }
 
 /**
- * Decode group type 2 data.
- *
- * Group type 2 is Radiotext.
+ * Decode group type 1A: Program Item Number and slow labeling codes.
  */
-static void decode_group_type_2(const struct rds_decoder* decoder,
-                                const struct rds_group_type gt,
-                                const struct rds_blocks* blocks) {
-  uint8_t rtchars[4];
-
-  enum rds_rt_text decode_rt = (blocks->b.val & 0x0010) >> 4 ? RT_A : RT_B;
-  struct rds_rt* rt =
-      decode_rt == RT_A ? &decoder->rds->rt.a : &decoder->rds->rt.b;
-
-  if (gt.version == 'A') {
-    if (blocks->c.errors > BLERC_MAX || blocks->d.errors > BLERD_MAX)
-      return;
-    rtchars[0] = (uint8_t)(blocks->c.val >> 8);
-    rtchars[1] = (uint8_t)(blocks->c.val & 0xFF);
-    rtchars[2] = (uint8_t)(blocks->d.val >> 8);
-    rtchars[3] = (uint8_t)(blocks->d.val & 0xFF);
+static void decode_group_1a(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+  decode_slow_labelling_codes(decoder->rds, blocks);
+  decode_group_1b(decoder, blocks);
+}
 
-    const uint8_t addr = (blocks->b.val & 0xf) * 4;
+#if RDS_ENABLE_RT
 
-    update_rt_simple(rt, blocks, 4, addr, rtchars);
-    if (decoder->rds->rt.decode_rt != decode_rt)
-      bump_rt_validation_count(rt);
-    update_rt_advance(rt, blocks, 4, addr, rtchars);
-  } else {
-    if (blocks->d.errors > BLERD_MAX)
-      return;
-    rtchars[0] = (uint8_t)(blocks->d.val >> 8);
-    rtchars[1] = (uint8_t)(blocks->d.val & 0xFF);
-    rtchars[2] = 0;
-    rtchars[3] = 0;
+/**
+ * Return the Radiotext that block B's text A/B flag selects.
+ */
+static enum rds_rt_text rt_text(const struct rds_blocks* blocks) {
+  return (blocks->b.val & 0x0010) >> 4 ? RT_A : RT_B;
+}
 
-    const uint8_t addr = (blocks->b.val & 0xf) * 2;
+/**
+ * Update the RT selected by \p decode_rt with the characters at \p addr.
+ */
+static void update_rt(const struct rds_decoder* decoder,
+                      const struct rds_blocks* blocks,
+                      enum rds_rt_text decode_rt,
+                      uint8_t count,
+                      uint8_t addr,
+                      uint8_t* rtchars) {
+  struct rds_rt* rt =
+      decode_rt == RT_A ? &decoder->rds->rt.a : &decoder->rds->rt.b;
+  uint8_t prev_display[sizeof(rt->display)];
+  memcpy(prev_display, rt->display, sizeof(prev_display));
 
+  if (count == 2) {
     // The last 32 bytes are unused in this format.
     rt->display[32] = 0x0d;
     rt->pvt.hi_prob[32] = 0x0d;
     rt->pvt.lo_prob[32] = 0x0d;
     rt->pvt.hi_prob_cnt[32] = RT_VALIDATE_LIMIT;
+  }
+
+  update_rt_simple(rt, blocks, count, addr, rtchars);
+  if (decoder->rds->rt.decode_rt != decode_rt)
+    clear_rt_validation(rt);
+  update_rt_advance(rt, blocks, count, addr, rtchars);
 
-    update_rt_simple(rt, blocks, 2, addr, rtchars);
-    if (decoder->rds->rt.decode_rt != decode_rt)
-      bump_rt_validation_count(rt);
-    update_rt_advance(rt, blocks, 2, addr, rtchars);
+  if (decoder->rds->rt.decode_rt != decode_rt ||
+      memcmp(prev_display, rt->display, sizeof(prev_display))) {
+    set_changed(decoder->rds, RDS_RT_IDX);
   }
   decoder->rds->rt.decode_rt = decode_rt;
-  SET_BITS(decoder->rds->valid_values, RDS_RT);
+  set_valid(decoder->rds, RDS_RT_IDX);
 #if defined(RDS_DEV)
   decoder->rds->stats.counts[PKTCNT_RT]++;
 #endif
 }
 
+/**
+ * Decode group type 2A: Radiotext (64 characters).
+ */
+static void decode_group_2a(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+  if (blocks->c.errors > BLERC_MAX || blocks->d.errors > BLERD_MAX)
+    return;
+
+  uint8_t rtchars[4];
+  rtchars[0] = (uint8_t)(blocks->c.val >> 8);
+  rtchars[1] = (uint8_t)(blocks->c.val & 0xFF);
+  rtchars[2] = (uint8_t)(blocks->d.val >> 8);
+  rtchars[3] = (uint8_t)(blocks->d.val & 0xFF);
+
+  const uint8_t addr = (blocks->b.val & 0xf) * 4;
+  update_rt(decoder, blocks, rt_text(blocks), 4, addr, rtchars);
+}
+
+/**
+ * Decode group type 2B: Radiotext (32 characters).
+ */
+static void decode_group_2b(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+  if (blocks->d.errors > BLERD_MAX)
+    return;
+
+  uint8_t rtchars[4];
+  rtchars[0] = (uint8_t)(blocks->d.val >> 8);
+  rtchars[1] = (uint8_t)(blocks->d.val & 0xFF);
+  rtchars[2] = 0;
+  rtchars[3] = 0;
+
+  const uint8_t addr = (blocks->b.val & 0xf) * 2;
+  update_rt(decoder, blocks, rt_text(blocks), 2, addr, rtchars);
+}
+
+#endif  // RDS_ENABLE_RT
+
+#if RDS_ENABLE_ODA
+
 /**
  * Decode open data.
+ *
+ * @return true if group type \p gt is used by an ODA.
  */
-static void decode_oda(const struct rds_decoder* decoder,
+static bool decode_oda(const struct rds_decoder* decoder,
                        const struct rds_group_type gt,
                        const struct rds_blocks* blocks) {
-  uint8_t idx = 0;
-  for (; idx < decoder->rds->oda_cnt; idx++) {
-    if (GroupTypesEqual(decoder->rds->oda[idx].gt, gt))
-      break;
-  }
-  if (idx == decoder->rds->oda_cnt)
-    return;
+  const int idx = find_oda_by_group_type(decoder->rds, gt);
+  if (idx < 0)
+    return false;
 
   decoder->rds->oda[idx].pkt_count++;
   if (decoder->oda.decode_cb) {
     decoder->oda.decode_cb(decoder->rds->oda[idx].id, decoder->rds, blocks, gt,
                            decoder->oda.cb_data);
   }
+  return true;
 }
 
 /**
- * Decode group type 3 data.
- *
- * See section 3.1.5.4 in RBDS specification.
+ * Decode a group which only carries open data.
+ */
+static void decode_group_oda(const struct rds_decoder* decoder,
+                             const struct rds_blocks* blocks) {
+  decode_oda(decoder, group_type(blocks), blocks);
+}
+
+/**
+ * Decode a group type which carries open data if assigned to an ODA, and
+ * otherwise carries some other data.
  *
- *  3A: Application Identification for Open Data.
- *  3B: Open data application.
+ * @return true if the group carried open data.
  */
-static void decode_group_type_3(const struct rds_decoder* decoder,
-                                const struct rds_group_type gt,
-                                const struct rds_blocks* blocks) {
-  if (gt.version == 'A') {
-    // Entire block is app id (AID) so we want no errors.
-    if (blocks->d.errors == BLER_NONE) {
-      const uint16_t app_id = blocks->d.val;
-      if (!IsValidODAAppId(app_id))
-        return;
-      // See if this ODA is already in our iist.
-      uint8_t idx = 0;
-      while (idx < decoder->rds->oda_cnt) {
-        if (decoder->rds->oda[idx].id == app_id) {
-          // Reset it - just in case it changes.
-          decoder->rds->oda[idx].gt.code = (blocks->b.val & 0b11110) >> 1;
-          decoder->rds->oda[idx].gt.version = blocks->b.val & 0x1 ? 'B' : 'A';
-          break;
-        }
-        idx++;
-      }
-      if (idx == decoder->rds->oda_cnt && idx < ARRAY_SIZE(decoder->rds->oda)) {
-        decoder->rds->oda[idx].id = app_id;
-        decoder->rds->oda[idx].gt.code = (blocks->b.val & 0b11110) >> 1;
-        decoder->rds->oda[idx].gt.version = blocks->b.val & 0x1 ? 'B' : 'A';
-        decoder->rds->oda_cnt++;
+static bool decode_if_oda(const struct rds_decoder* decoder,
+                          const struct rds_blocks* blocks) {
+  return decode_oda(decoder, group_type(blocks), blocks);
+}
 
-        // TODO - Finish Group 3A ODA bits.
+/**
+ * Decode group type 3A: Application Identification for Open Data.
+ *
+ * See section 3.1.5.4 in RBDS specification.
+ */
+static void decode_group_3a(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+  // Entire block is app id (AID) so we want no errors.
+  if (blocks->d.errors != BLER_NONE)
+    return;
+  const uint16_t app_id = blocks->d.val;
+  if (!IsValidODAAppId(app_id))
+    return;
+  struct rds_data* rds = decoder->rds;
+  const struct rds_group_type gt = {
+      .code = (blocks->b.val & 0b11110) >> 1,
+      .version = blocks->b.val & 0x1 ? 'B' : 'A',
+  };
+  // See if this ODA is already in our iist.
+  const int idx = find_oda_by_aid(rds, app_id);
+  if (idx >= 0) {
+    // Reset it - just in case it changes.
+    const struct rds_group_type prev_gt = rds->oda[idx].gt;
+    if (!GroupTypesEqual(prev_gt, gt)) {
+      rds->oda[idx].gt = gt;
+      update_oda_group_type(rds, prev_gt);
+      update_oda_group_type(rds, gt);
+    }
+  } else if (rds->oda_cnt < ARRAY_SIZE(rds->oda)) {
+    const uint8_t new_idx = rds->oda_cnt++;
+    rds->oda[new_idx].id = app_id;
+    rds->oda[new_idx].gt = gt;
+    add_oda_aid(rds, new_idx);
+    update_oda_group_type(rds, gt);
+
+    // TODO - Finish Group 3A ODA bits.
 #if 0
-        if (app_id == AID_RT_PLUS) {
-          // Don't currently suport templates. These are in the C block.
+    if (app_id == AID_RT_PLUS) {
+      // Don't currently suport templates. These are in the C block.
   const uint16_t rfu_mask  = 0x1110000000000000; // future use.
   const uint16_t cb_flag   = 0x0001000000000000;
   const uint16_t scb_mask  = 0x0000111100000000; // Server control bits.
   const uint16_t tmpt_mask = 0x0000000011111111;
-        }
-#endif
-      }
     }
-  } else {
-    decode_oda(decoder, gt, blocks);
+#endif
   }
 }
 
+#else  // RDS_ENABLE_ODA
+
+/**
+ * Decode a group type which carries open data if assigned to an ODA, and
+ * otherwise carries some other data.
+ *
+ * @return true if the group carried open data.
+ */
+static bool decode_if_oda(const struct rds_decoder* decoder,
+                          const struct rds_blocks* blocks) {
+  UNUSED(decoder);
+  UNUSED(blocks);
+  return false;
+}
+
+#endif  // RDS_ENABLE_ODA
+
+#if RDS_ENABLE_CLOCK
+
 /**
- * Decode the Clock IAW RBDS standard, sect. 3.1.5.6.
+ * Decode group type 4A: Clock-time and date IAW RBDS standard, sect. 3.1.5.6.
  */
-static void update_clock(const struct rds_decoder* decoder,
-                         const struct rds_blocks* blocks) {
+static void decode_group_4a(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
   if (blocks->b.errors > BLERB_MAX)
     return;
   if (blocks->c.errors > BLERC_MAX)
@@ -681,43 +879,44 @@ static void update_clock(const struct rds_decoder* decoder,
 
   // clang-format on
 
-  SET_BITS(decoder->rds->valid_values, RDS_CLOCK);
+  set_valid(decoder->rds, RDS_CLOCK_IDX);
 #if defined(RDS_DEV)
   decoder->rds->stats.counts[PKTCNT_CLOCK]++;
 #endif
 
+  struct rds_clock_t clock;
+  memset(&clock, 0, sizeof(clock));  // Keep the padding deterministic.
   // Julian date is a 17-bit value.
-  decoder->rds->clock.day_high = (b & B_JDATE) >> 1;
-  decoder->rds->clock.day_low = ((b & 0x1) << 15) | ((c & C_JDATE) >> 1);
-  decoder->rds->clock.hour = ((c & 0x1) << 4) | ((d & D_HOUR) >> 12);
-  decoder->rds->clock.minute = ((d & D_MINUTE) >> 6);
-  decoder->rds->clock.utc_offset = d & D_UTC_OFFSET;
+  clock.day_high = (b & B_JDATE) >> 1;
+  clock.day_low = ((b & 0x1) << 15) | ((c & C_JDATE) >> 1);
+  clock.hour = ((c & 0x1) << 4) | ((d & D_HOUR) >> 12);
+  clock.minute = ((d & D_MINUTE) >> 6);
+  clock.utc_offset = d & D_UTC_OFFSET;
   if (d & D_UTC_OFFSET_SIGN)
-    decoder->rds->clock.utc_offset = -decoder->rds->clock.utc_offset;
-}
+    clock.utc_offset = -clock.utc_offset;
 
-/**
- * Decode group type 4 data.
- *
- *  4A: Clock-time and date.
- *  4B: Open data application.
- */
-static void decode_group_type_4(const struct rds_decoder* decoder,
-                                const struct rds_group_type gt,
-                                const struct rds_blocks* blocks) {
-  if (gt.version == 'A')
-    update_clock(decoder, blocks);
-  else
-    decode_oda(decoder, gt, blocks);
+  const struct rds_clock_t* prev = &decoder->rds->clock;
+  if (clock.day_high != prev->day_high || clock.day_low != prev->day_low ||
+      clock.hour != prev->hour || clock.minute != prev->minute ||
+      clock.utc_offset != prev->utc_offset) {
+    set_changed(decoder->rds, RDS_CLOCK_IDX);
+  }
+  decoder->rds->clock = clock;
 }
 
+#endif  // RDS_ENABLE_CLOCK
+
+#if RDS_ENABLE_TDC
+
 static void decode_tdc_block(struct rds_data* rds,
                              const struct rds_block* block) {
   const uint8_t channel = rds->tdc.curr_channel;
   if (channel >= NUM_TDC)
     return;
 
-  SET_BITS(rds->valid_values, RDS_TDC);
+  // Each block is new data in the channel's stream.
+  set_valid(rds, RDS_TDC_IDX);
+  set_changed(rds, RDS_TDC_IDX);
 #if defined(RDS_DEV)
   rds->stats.counts[PKTCNT_TDC]++;
 #endif
@@ -728,28 +927,29 @@ static void decode_tdc_block(struct rds_data* rds,
 }
 
 /**
- * Decode group type 5 data.
- *
- *  5A: Transparent data channels or ODA.
- *  5B: Transparent data channels or ODA.
+ * Decode group type 5A: Transparent data channels or ODA.
  */
-static void decode_group_type_5(const struct rds_decoder* decoder,
-                                const struct rds_group_type gt,
-                                const struct rds_blocks* blocks) {
-  if (IsGroupTypeUsedByODA(decoder->rds, gt)) {
-    decode_oda(decoder, gt, blocks);
+static void decode_group_5a(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+  if (decode_if_oda(decoder, blocks))
     return;
-  }
-  // Used for TDC.
-  if (gt.version == 'A') {
-    decoder->rds->tdc.curr_channel = blocks->b.val & 0x11111;
-    decode_tdc_block(decoder->rds, &blocks->c);
-    decode_tdc_block(decoder->rds, &blocks->d);
-  } else {
-    decode_tdc_block(decoder->rds, &blocks->d);
-  }
+  decoder->rds->tdc.curr_channel = blocks->b.val & 0x11111;
+  decode_tdc_block(decoder->rds, &blocks->c);
+  decode_tdc_block(decoder->rds, &blocks->d);
 }
 
+/**
+ * Decode group type 5B: Transparent data channels or ODA.
+ */
+static void decode_group_5b(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+  if (decode_if_oda(decoder, blocks))
+    return;
+  decode_tdc_block(decoder->rds, &blocks->d);
+}
+
+#endif  // RDS_ENABLE_TDC
+
 static void decode_in_house_data(const struct rds_decoder* decoder) {
 #if defined(RDS_DEV)
   decoder->rds->stats.counts[PKTCNT_IH]++;
@@ -761,18 +961,12 @@ static void decode_in_house_data(const struct rds_decoder* decoder) {
 }
 
 /**
- * Decode group type 6 data.
- *
- *  6A: In-house applications or ODA (pt 1).
- *  6B: In-house applications or ODA (pt 2).
+ * Decode group type 6A/6B: In-house applications or ODA.
  */
-static void decode_group_type_6(const struct rds_decoder* decoder,
-                                const struct rds_group_type gt,
-                                const struct rds_blocks* blocks) {
-  if (IsGroupTypeUsedByODA(decoder->rds, gt)) {
-    decode_oda(decoder, gt, blocks);
+static void decode_group_6(const struct rds_decoder* decoder,
+                           const struct rds_blocks* blocks) {
+  if (decode_if_oda(decoder, blocks))
     return;
-  }
   decode_in_house_data(decoder);
 }
 
@@ -786,22 +980,13 @@ static void decode_radio_paging(const struct rds_decoder* decoder) {
 }
 
 /**
- * Decode group type 7 data.
- *
- *  7A: Radio Paging.
- *  7B: Open data application.
+ * Decode group type 7A: Radio Paging or ODA.
  */
-static void decode_group_type_7(const struct rds_decoder* decoder,
-                                const struct rds_group_type gt,
-                                const struct rds_blocks* blocks) {
-  if (gt.version == 'A') {
-    if (IsGroupTypeUsedByODA(decoder->rds, gt))
-      decode_oda(decoder, gt, blocks);
-    else
-      decode_radio_paging(decoder);
-  } else {
-    decode_oda(decoder, gt, blocks);
-  }
+static void decode_group_7a(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+  if (decode_if_oda(decoder, blocks))
+    return;
+  decode_radio_paging(decoder);
 }
 
 /**
@@ -817,23 +1002,17 @@ static void decode_tmc(const struct rds_decoder* decoder) {
 }
 
 /**
- * Decode group type 8 data.
- *
- *  8A: Traffic Message Channel.
- *  8B: Open data.
+ * Decode group type 8A: Traffic Message Channel or ODA.
  */
-static void decode_group_type_8(const struct rds_decoder* decoder,
-                                const struct rds_group_type gt,
-                                const struct rds_blocks* blocks) {
-  if (IsGroupTypeUsedByODA(decoder->rds, gt)) {
-    decode_oda(decoder, gt, blocks);
+static void decode_group_8a(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+  if (decode_if_oda(decoder, blocks))
     return;
-  }
-
-  if (gt.version == 'A')
-    decode_tmc(decoder);
+  decode_tmc(decoder);
 }
 
+#if RDS_ENABLE_EWS
+
 static void decode_ews(const struct rds_decoder* decoder,
                        const struct rds_blocks* blocks) {
 #if defined(RDS_DEV)
@@ -842,7 +1021,12 @@ static void decode_ews(const struct rds_decoder* decoder,
 
   // Format and application of the bits allocated for EWS messages may be
   // assigned unilaterally by each country.
-  SET_BITS(decoder->rds->valid_values, RDS_EWS);
+  set_valid(decoder->rds, RDS_EWS_IDX);
+  if ((decoder->rds->ews.b.val != (blocks->b.val & 0b11111)) ||
+      decoder->rds->ews.c.val != blocks->c.val ||
+      decoder->rds->ews.d.val != blocks->d.val) {
+    set_changed(decoder->rds, RDS_EWS_IDX);
+  }
   decoder->rds->ews.b = blocks->b;
   decoder->rds->ews.b.val = decoder->rds->ews.b.val & 0b11111;
   decoder->rds->ews.c = blocks->c;
@@ -850,31 +1034,30 @@ static void decode_ews(const struct rds_decoder* decoder,
 }
 
 /**
- * Decode group type 9 data.
- *
- *  9A: Allocation of EWS message bits.
- *  9B: Open data.
+ * Decode group type 9A: Allocation of EWS message bits or ODA.
  */
-static void decode_group_type_9(const struct rds_decoder* decoder,
-                                const struct rds_group_type gt,
-                                const struct rds_blocks* blocks) {
-  if (IsGroupTypeUsedByODA(decoder->rds, gt)) {
-    decode_oda(decoder, gt, blocks);
+static void decode_group_9a(const struct rds_decoder* decoder,
+                            const struct rds_blocks* blocks) {
+  if (decode_if_oda(decoder, blocks))
     return;
-  }
-
-  if (gt.version == 'A')
-    decode_ews(decoder, blocks);
+  decode_ews(decoder, blocks);
 }
 
+#endif  // RDS_ENABLE_EWS
+
+#if RDS_ENABLE_PTYN
+
 static void update_ptyn(struct rds_data* rds, uint8_t char_idx, uint8_t ch) {
   if (char_idx >= ARRAY_SIZE(rds->ptyn.display))
     return;
-  rds->ptyn.display[char_idx] = ch;
+  update_byte(rds, RDS_PTYN_IDX, &rds->ptyn.display[char_idx], ch);
 }
 
-static void decode_ptyn(const struct rds_decoder* decoder,
-                        const struct rds_blocks* blocks) {
+/**
+ * Decode group type 10A: Program Type Name (PTYN).
+ */
+static void decode_group_10a(const struct rds_decoder* decoder,
+                             const struct rds_blocks* blocks) {
   // clang-format off
 
   #define B_PTYN_AB_FLAG      0b10000
@@ -883,12 +1066,13 @@ static void decode_ptyn(const struct rds_decoder* decoder,
 
   // clang-format on
 
-  SET_BITS(decoder->rds->valid_values, RDS_PTYN);
+  set_valid(decoder->rds, RDS_PTYN_IDX);
 #if defined(RDS_DEV)
   decoder->rds->stats.counts[PKTCNT_PTYN]++;
 #endif
   const bool ab_val = blocks->b.val & B_PTYN_AB_FLAG;
   if (decoder->rds->ptyn.last_ab != ab_val) {
+    set_changed(decoder->rds, RDS_PTYN_IDX);
     memset(decoder->rds->ptyn.display, 0, sizeof(decoder->rds->ptyn.display));
     decoder->rds->ptyn.last_ab = ab_val;
   }
@@ -904,56 +1088,9 @@ static void decode_ptyn(const struct rds_decoder* decoder,
   }
 }
 
-/**
- * Decode group type 10 data.
- *
- *  10A: Program Type Name (PTYN).
- *  10B: Open data.
- */
-static void decode_group_type_10(const struct rds_decoder* decoder,
-                                 const struct rds_group_type gt,
-                                 const struct rds_blocks* blocks) {
-  if (gt.version == 'A')
-    decode_ptyn(decoder, blocks);
-  else
-    decode_oda(decoder, gt, blocks);
-}
+#endif  // RDS_ENABLE_PTYN
 
-/**
- * Decode group type 11 data.
- *
- *  11A: Open data.
- *  11B: Open data.
- */
-static void decode_group_type_11(const struct rds_decoder* decoder,
-                                 const struct rds_group_type gt,
-                                 const struct rds_blocks* blocks) {
-  decode_oda(decoder, gt, blocks);
-}
-
-/**
- * Decode group type 12 data.
- *
- *  12A: Open data.
- *  12B: Open data.
- */
-static void decode_group_type_12(const struct rds_decoder* decoder,
-                                 const struct rds_group_type gt,
-                                 const struct rds_blocks* blocks) {
-  decode_oda(decoder, gt, blocks);
-}
-
-/**
- * Decode group type 13 data.
- *
- *  13A: Open data.
- *  13B: Open data.
- */
-static void decode_group_type_13(const struct rds_decoder* decoder,
-                                 const struct rds_group_type gt,
-                                 const struct rds_blocks* blocks) {
-  decode_oda(decoder, gt, blocks);
-}
+#if RDS_ENABLE_EON
 
 /**
  * Decode block EON data from block 14A.
@@ -983,32 +1120,35 @@ static void decode_eon_block_a(struct rds_data* rds,
 
   switch (blocks->b.val & 0xf) {  // Low four bits is variant code.
     case EON_VC_PS1:
-      rds->eon.on.ps[0] = blocks->c.val >> 8;
-      rds->eon.on.ps[1] = blocks->c.val & 0xFF;
+      update_byte(rds, RDS_EON_IDX, &rds->eon.on.ps[0], blocks->c.val >> 8);
+      update_byte(rds, RDS_EON_IDX, &rds->eon.on.ps[1], blocks->c.val & 0xFF);
       break;
     case EON_VC_PS2:
-      rds->eon.on.ps[2] = blocks->c.val >> 8;
-      rds->eon.on.ps[3] = blocks->c.val & 0xFF;
+      update_byte(rds, RDS_EON_IDX, &rds->eon.on.ps[2], blocks->c.val >> 8);
+      update_byte(rds, RDS_EON_IDX, &rds->eon.on.ps[3], blocks->c.val & 0xFF);
       break;
     case EON_VC_PS3:
-      rds->eon.on.ps[4] = blocks->c.val >> 8;
-      rds->eon.on.ps[5] = blocks->c.val & 0xFF;
+      update_byte(rds, RDS_EON_IDX, &rds->eon.on.ps[4], blocks->c.val >> 8);
+      update_byte(rds, RDS_EON_IDX, &rds->eon.on.ps[5], blocks->c.val & 0xFF);
       break;
     case EON_VC_PS4:
-      rds->eon.on.ps[6] = blocks->c.val >> 8;
-      rds->eon.on.ps[7] = blocks->c.val & 0xFF;
+      update_byte(rds, RDS_EON_IDX, &rds->eon.on.ps[6], blocks->c.val >> 8);
+      update_byte(rds, RDS_EON_IDX, &rds->eon.on.ps[7], blocks->c.val & 0xFF);
       break;
     case EON_VC_AF: {  // See RBDS 3.2.1.6.6.
       const uint8_t first_byte = blocks->c.val >> 8;
+      bool added;
       if (is_freq_code_count(first_byte)) {
         rds->eon.on.af.pvt.band = AF_BAND_UHF;
-        decode_freq_table_start_block(&rds->eon.on.af,
-                                      freq_code_to_count(first_byte),
-                                      blocks->c.val & 0xFF);
+        added = decode_freq_table_start_block(&rds->eon.on.af,
+                                              freq_code_to_count(first_byte),
+                                              blocks->c.val & 0xFF);
       } else {
-        decode_freq_table_nth_block(&rds->eon.on.af, first_byte,
-                                    blocks->c.val & 0xFF);
+        added = decode_freq_table_nth_block(&rds->eon.on.af, first_byte,
+                                            blocks->c.val & 0xFF);
       }
+      if (added)
+        set_changed(rds, RDS_EON_IDX);
     } break;
     case EON_VC_FREQ1:
       break;
@@ -1026,10 +1166,14 @@ static void decode_eon_block_a(struct rds_data* rds,
       break;
     case EON_VC_LINKAGE:
       break;
-    case EON_VC_PTY_TA:
-      rds->eon.on.pty = blocks->c.val > 11;       // top five bits.
-      rds->eon.on.ta_code = blocks->c.val & 0x1;  // bottom bit.
-      break;
+    case EON_VC_PTY_TA: {
+      const uint8_t pty = blocks->c.val > 11;      // top five bits.
+      const bool ta_code = blocks->c.val & 0x1;  // bottom bit.
+      if (rds->eon.on.pty != pty || rds->eon.on.ta_code != ta_code)
+        set_changed(rds, RDS_EON_IDX);
+      rds->eon.on.pty = pty;
+      rds->eon.on.ta_code = ta_code;
+    } break;
     case EON_VC_PIN:
       break;
     case EON_VC_RESERVED:
@@ -1038,31 +1182,50 @@ static void decode_eon_block_a(struct rds_data* rds,
 }
 
 /**
- * Decode group type 14 data IAW RBDS spec. 3.1.5.19.
- *
- *  14A: Enhanced Other Networks (OEN) information.
- *  14B: Enhanced Other Networks (OEN) information.
+ * Count a group of Enhanced Other Networks (EON) information.
  */
-static void decode_group_type_14(const struct rds_decoder* decoder,
-                                 const struct rds_group_type gt,
-                                 const struct rds_blocks* blocks) {
+static void count_eon(const struct rds_decoder* decoder) {
 #if defined(RDS_DEV)
   decoder->rds->stats.counts[PKTCNT_EON]++;
 #endif
 
-  SET_BITS(decoder->rds->valid_values, RDS_EON);
+  set_valid(decoder->rds, RDS_EON_IDX);
+}
+
+/**
+ * Decode group type 14A: Enhanced Other Networks (OEN) information IAW RBDS
+ * spec. 3.1.5.19.
+ */
+static void decode_group_14a(const struct rds_decoder* decoder,
+                             const struct rds_blocks* blocks) {
+  count_eon(decoder);
+  decode_eon_block_a(decoder->rds, blocks);
+}
 
+/**
+ * Decode group type 14B: Enhanced Other Networks (OEN) information IAW RBDS
+ * spec. 3.1.5.19.
+ */
+static void decode_group_14b(const struct rds_decoder* decoder,
+                             const struct rds_blocks* blocks) {
+  count_eon(decoder);
+
+  struct rds_data* rds = decoder->rds;
   // See sect. 3.2.1.8.
-  if (gt.version == 'A') {
-    decode_eon_block_a(decoder->rds, blocks);
-  } else {
-    if (blocks->d.errors <= BLERD_MAX)
-      decoder->rds->eon.on.pi_code = blocks->d.val;
-    decoder->rds->eon.on.tp_code = (blocks->b.val & 0b1000) ? true : false;
-    decoder->rds->eon.on.ta_code = (blocks->b.val & 0b0100) ? true : false;
+  if (blocks->d.errors <= BLERD_MAX && rds->eon.on.pi_code != blocks->d.val) {
+    rds->eon.on.pi_code = blocks->d.val;
+    set_changed(rds, RDS_EON_IDX);
   }
+  const bool tp_code = (blocks->b.val & 0b1000) ? true : false;
+  const bool ta_code = (blocks->b.val & 0b0100) ? true : false;
+  if (rds->eon.on.tp_code != tp_code || rds->eon.on.ta_code != ta_code)
+    set_changed(rds, RDS_EON_IDX);
+  rds->eon.on.tp_code = tp_code;
+  rds->eon.on.ta_code = ta_code;
 }
 
+#endif  // RDS_ENABLE_EON
+
 static void decode_fast_basic_tuning(const struct rds_decoder* decoder,
                                      const struct rds_blocks* blocks) {
 #if defined(RDS_DEV)
@@ -1075,36 +1238,94 @@ static void decode_fast_basic_tuning(const struct rds_decoder* decoder,
 }
 
 /**
- * Decode group type 15 data.
+ * Decode group type 15A.
  *
- *  15A: Fast basic tuning and switching information.
- *  15B: Fast basic tuning and switching information.
+ * According to 1998 RBDS specifiction fast basic tuning in 15A is being
+ * phased out, and as of 2008 this should be available for reuse.
  */
-static void decode_group_type_15(const struct rds_decoder* decoder,
-                                 const struct rds_group_type gt,
-                                 const struct rds_blocks* blocks) {
-  if (gt.version == 'A') {
-    // According to 1998 RBDS specifiction fast basic tuning in 15A is being
-    // phased out, and as of 2008 this should be available for reuse.
-  } else {
-    decode_fast_basic_tuning(decoder, blocks);
-  }
+static void decode_group_15a(const struct rds_decoder* decoder,
+                             const struct rds_blocks* blocks) {
   decode_ta(decoder->rds, &blocks->b);
 }
 
-/******************************************/
-/*vvvvvvvvvv EXPORTED FUNCTIONS *vvvvvvvvv*/
-/******************************************/
+/**
+ * Decode group type 15B: Fast basic tuning and switching information.
+ */
+static void decode_group_15b(const struct rds_decoder* decoder,
+                             const struct rds_blocks* blocks) {
+  decode_fast_basic_tuning(decoder, blocks);
+  decode_ta(decoder->rds, &blocks->b);
+}
 
-void rds_decoder_decode(struct rds_decoder* decoder,
-                        const struct rds_blocks* blocks) {
+// The handlers of optional features which are compiled out. Group types
+// which can carry open data are still routed to an ODA.
+
+#if !RDS_ENABLE_ODA
+#define decode_group_oda NULL
+#define decode_group_3a NULL
+#endif
+#if !RDS_ENABLE_RT
+#define decode_group_2a NULL
+#define decode_group_2b NULL
+#endif
+#if !RDS_ENABLE_CLOCK
+#define decode_group_4a NULL
+#endif
+#if !RDS_ENABLE_TDC
+#define decode_group_5a decode_group_oda
+#define decode_group_5b decode_group_oda
+#endif
+#if !RDS_ENABLE_EWS
+#define decode_group_9a decode_group_oda
+#endif
+#if !RDS_ENABLE_PTYN
+#define decode_group_10a NULL
+#endif
+#if !RDS_ENABLE_EON
+#define decode_group_14a NULL
+#define decode_group_14b NULL
+#endif
+
+// clang-format off
+
+/**
+ * The default group handlers, indexed by group type code and version.
+ */
+static const DecodeGroupFunc kDefaultGroupHandlers[RDS_NUM_GROUP_TYPES] = {
+    decode_group_0a,  decode_group_0b,   // 0A, 0B
+    decode_group_1a,  decode_group_1b,   // 1A, 1B
+    decode_group_2a,  decode_group_2b,   // 2A, 2B
+    decode_group_3a,  decode_group_oda,  // 3A, 3B
+    decode_group_4a,  decode_group_oda,  // 4A, 4B
+    decode_group_5a,  decode_group_5b,   // 5A, 5B
+    decode_group_6,   decode_group_6,    // 6A, 6B
+    decode_group_7a,  decode_group_oda,  // 7A, 7B
+    decode_group_8a,  decode_group_oda,  // 8A, 8B
+    decode_group_9a,  decode_group_oda,  // 9A, 9B
+    decode_group_10a, decode_group_oda,  // 10A, 10B
+    decode_group_oda, decode_group_oda,  // 11A, 11B
+    decode_group_oda, decode_group_oda,  // 12A, 12B
+    decode_group_oda, decode_group_oda,  // 13A, 13B
+    decode_group_14a, decode_group_14b,  // 14A, 14B
+    decode_group_15a, decode_group_15b,  // 15A, 15B
+};
+
+// clang-format on
+
+/**
+ * Decode a single group.
+ *
+ * This is the common implementation of the exported decode functions, and is
+ * inlined into each so that the batch decoder has no per-group call overhead.
+ */
+static inline void decode_group(struct rds_decoder* decoder,
+                                const struct rds_blocks* blocks) {
 #if defined(RDS_DEV)
   decoder->rds->stats.data_cnt++;
 #endif
 
   if (blocks->a.errors <= BLERA_MAX) {
-    decoder->rds->pi_code = blocks->a.val;
-    SET_BITS(decoder->rds->valid_values, RDS_PI_CODE);
+    update_pi_code(decoder->rds, blocks->a.val);
 #if defined(RDS_DEV)
     decoder->rds->stats.counts[PKTCNT_PI_CODE]++;
 #endif
@@ -1117,97 +1338,121 @@ void rds_decoder_decode(struct rds_decoder* decoder,
     return;
   }
 
-  const struct rds_group_type gt = {
-      .code = (blocks->b.val & GT_CODE_MASK) >> 12,
-      .version = blocks->b.val & VERSION_CODE ? 'B' : 'A',
-  };
+  const uint8_t idx = group_idx(blocks);
+  const bool version_b = blocks->b.val & VERSION_CODE;
 
-  if (gt.version == 'B' && blocks->c.errors <= BLERC_MAX &&
+  if (version_b && blocks->c.errors <= BLERC_MAX &&
       blocks->c.errors < blocks->b.errors) {
-    decoder->rds->pi_code = blocks->c.val;
-    SET_BITS(decoder->rds->valid_values, RDS_PI_CODE);
+    update_pi_code(decoder->rds, blocks->c.val);
 #if defined(RDS_DEV)
     decoder->rds->stats.counts[PKTCNT_PI_CODE]++;
 #endif
   }
 
 #if defined(RDS_DEV)
-  if (gt.version == 'A')
-    decoder->rds->stats.groups[gt.code].a++;
+  if (version_b)
+    decoder->rds->stats.groups[idx >> 1].b++;
   else
-    decoder->rds->stats.groups[gt.code].b++;
+    decoder->rds->stats.groups[idx >> 1].a++;
 #endif
 
   decode_pty(decoder->rds, &blocks->b);
 
-  switch (gt.code) {
-    case 0:
-      decode_group_type_0(decoder, gt, blocks);
-      break;
-    case 1:
-      decode_group_type_1(decoder, gt, blocks);
-      break;
-    case 2:
-      decode_group_type_2(decoder, gt, blocks);
-      break;
-    case 3:
-      decode_group_type_3(decoder, gt, blocks);
-      break;
-    case 4:
-      decode_group_type_4(decoder, gt, blocks);
-      break;
-    case 5:
-      decode_group_type_5(decoder, gt, blocks);
-      break;
-    case 6:
-      decode_group_type_6(decoder, gt, blocks);
-      break;
-    case 7:
-      decode_group_type_7(decoder, gt, blocks);
-      break;
-    case 8:
-      decode_group_type_8(decoder, gt, blocks);
-      break;
-    case 9:
-      decode_group_type_9(decoder, gt, blocks);
-      break;
-    case 10:
-      decode_group_type_10(decoder, gt, blocks);
-      break;
-    case 11:
-      decode_group_type_11(decoder, gt, blocks);
-      break;
-    case 12:
-      decode_group_type_12(decoder, gt, blocks);
-      break;
-    case 13:
-      decode_group_type_13(decoder, gt, blocks);
-      break;
-    case 14:
-      decode_group_type_14(decoder, gt, blocks);
-      break;
-    case 15:
-      decode_group_type_15(decoder, gt, blocks);
-      break;
+  const DecodeGroupFunc handler = decoder->group_handlers[idx];
+  if (handler)
+    handler(decoder, blocks);
+}
+
+/**
+ * Publish the snapshot, and call the change callback, if any values were
+ * changed by the groups just decoded.
+ */
+static void notify_changes(const struct rds_decoder* decoder) {
+  if (!decoder->rds->changed_values)
+    return;
+  if (decoder->snapshot)
+    rds_snapshot_publish(decoder->snapshot, decoder->rds);
+  if (decoder->change.cb)
+    decoder->change.cb(decoder->rds, decoder->rds->changed_values,
+                       decoder->change.cb_data);
+}
+
+/******************************************/
+/*vvvvvvvvvv EXPORTED FUNCTIONS *vvvvvvvvv*/
+/******************************************/
+
+void rds_decoder_decode(struct rds_decoder* decoder,
+                        const struct rds_blocks* blocks) {
+  rds_decoder_decode_ts(decoder, blocks, 0);
+}
+
+void rds_decoder_decode_ts(struct rds_decoder* decoder,
+                           const struct rds_blocks* blocks,
+                           int64_t timestamp) {
+  decoder->rds->timestamp = timestamp;
+  decoder->rds->changed_values = 0;
+  decode_group(decoder, blocks);
+  notify_changes(decoder);
+}
+
+void rds_decoder_decode_batch(struct rds_decoder* decoder,
+                              const struct rds_blocks* groups,
+                              size_t n) {
+  decoder->rds->timestamp = 0;
+  decoder->rds->changed_values = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (i + PREFETCH_GROUPS < n)
+      PREFETCH(&groups[i + PREFETCH_GROUPS]);
+    decode_group(decoder, &groups[i]);
   }
+  notify_changes(decoder);
 }
 
 void rds_decoder_reset(struct rds_decoder* decoder) {
   memset(decoder->rds, 0, sizeof(struct rds_data));
+#if RDS_ENABLE_AF
   decoder->rds->af.pvt.current_table_idx = -1;
+#endif
+  if (decoder->snapshot)
+    rds_snapshot_publish(decoder->snapshot, decoder->rds);
   if (decoder->oda.clear_cb)
     decoder->oda.clear_cb(decoder->oda.cb_data);
 }
 
+void rds_decoder_init(struct rds_decoder* decoder,
+                      const struct rds_decoder_config* config) {
+  memset(decoder, 0, sizeof(*decoder));
+  decoder->rds = config->rds_data;
+  decoder->advanced_ps_decoding = config->advanced_ps_decoding;
+  memcpy(decoder->group_handlers, kDefaultGroupHandlers,
+         sizeof(decoder->group_handlers));
+}
+
 struct rds_decoder* rds_decoder_create(
     const struct rds_decoder_config* config) {
   struct rds_decoder* decoder =
-      (struct rds_decoder*)calloc(1, sizeof(struct rds_decoder));
-  decoder->rds = config->rds_data;
-  decoder->advanced_ps_decoding = config->advanced_ps_decoding;
+      (struct rds_decoder*)malloc(sizeof(struct rds_decoder));
+  if (decoder)
+    rds_decoder_init(decoder, config);
   return decoder;
 }
 
+DecodeGroupFunc rds_decoder_get_group_handler(
+    const struct rds_decoder* decoder,
+    struct rds_group_type gt) {
+  return decoder->group_handlers[gt_idx(gt)];
+}
+
+void rds_decoder_set_group_handler(struct rds_decoder* decoder,
+                                   struct rds_group_type gt,
+                                   DecodeGroupFunc handler) {
+  decoder->group_handlers[gt_idx(gt)] = handler;
+}
+
+DecodeGroupFunc rds_decoder_default_group_handler(struct rds_group_type gt) {
+  return kDefaultGroupHandlers[gt_idx(gt)];
+}
+
 void rds_decoder_delete(struct rds_decoder* decoder) {
   if (!decoder)
     return;
@@ -1222,3 +1467,17 @@ void rds_decoder_set_oda_callbacks(struct rds_decoder* decoder,
   decoder->oda.clear_cb = clear_cb;
   decoder->oda.cb_data = cb_data;
 }
+
+void rds_decoder_set_change_callback(struct rds_decoder* decoder,
+                                     ValuesChangedFunc change_cb,
+                                     void* cb_data) {
+  decoder->change.cb = change_cb;
+  decoder->change.cb_data = cb_data;
+}
+
+void rds_decoder_set_snapshot(struct rds_decoder* decoder,
+                              struct rds_snapshot* snapshot) {
+  decoder->snapshot = snapshot;
+  if (snapshot)
+    rds_snapshot_publish(snapshot, decoder->rds);
+}
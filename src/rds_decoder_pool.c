@@ -0,0 +1,276 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <rds_decoder.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rds_decoder_priv.h"
+#include "rds_misc.h"
+
+#define NO_STATION 0xFFFF  // A null station index.
+#define EMPTY_SLOT 0xFFFF  // An unused hash table slot.
+
+/**
+ * A station in a decoder pool.
+ *
+ * The station's decoder and rds_data (both much larger) are in separate
+ * slabs, so that the hash table probes and LRU list updates only touch this
+ * dense array of six byte records.
+ */
+struct pool_station {
+  uint16_t pi_code;
+  uint16_t prev;  ///< Previous (more recently used) station in the LRU list.
+  uint16_t next;  ///< Next (less recently used) station in the LRU list.
+};
+
+struct rds_decoder_pool {
+  struct rds_decoder_pool_config config;
+  struct pool_station* stations;  ///< Slab of config.capacity stations.
+  struct rds_decoder* decoders;   ///< Slab of the stations' decoders.
+  struct rds_data* data;          ///< Slab of the stations' decoded data.
+  uint16_t count;                 ///< The number of stations in use.
+  uint16_t mru;                   ///< The most recently used station.
+  uint16_t lru;                   ///< The least recently used station.
+
+  /**
+   * Open addressing (linear probing) hash table of station indices, keyed
+   * by PI code. This has at least twice as many slots as stations.
+   */
+  uint16_t* slots;
+  uint32_t slot_mask;  ///< The number of slots - 1.
+  uint8_t slot_shift;  ///< 32 - log2(number of slots).
+};
+
+/**
+ * Return the preferred hash table slot of \p pi_code.
+ */
+static uint32_t home_slot(const struct rds_decoder_pool* pool,
+                          uint16_t pi_code) {
+  // Fibonacci hashing: the top bits of the product are well mixed.
+  return (uint32_t)(pi_code * 2654435769u) >> pool->slot_shift;
+}
+
+/**
+ * Return the slot holding \p pi_code, or the empty slot where it would be
+ * inserted.
+ */
+static uint32_t find_slot(const struct rds_decoder_pool* pool,
+                          uint16_t pi_code) {
+  uint32_t slot = home_slot(pool, pi_code);
+  while (pool->slots[slot] != EMPTY_SLOT &&
+         pool->stations[pool->slots[slot]].pi_code != pi_code) {
+    slot = (slot + 1) & pool->slot_mask;
+  }
+  return slot;
+}
+
+/**
+ * Remove the station in \p slot from the hash table.
+ *
+ * Later entries in the same probe sequence are shifted back so that no
+ * tombstones are needed.
+ */
+static void remove_slot(struct rds_decoder_pool* pool, uint32_t slot) {
+  uint32_t next = slot;
+  while (true) {
+    next = (next + 1) & pool->slot_mask;
+    const uint16_t idx = pool->slots[next];
+    if (idx == EMPTY_SLOT)
+      break;
+    // Move the entry back if its home slot is not between the hole and its
+    // current position.
+    const uint32_t home = home_slot(pool, pool->stations[idx].pi_code);
+    const uint32_t home_dist = (next - home) & pool->slot_mask;
+    if (home_dist >= ((next - slot) & pool->slot_mask)) {
+      pool->slots[slot] = idx;
+      slot = next;
+    }
+  }
+  pool->slots[slot] = EMPTY_SLOT;
+}
+
+static void lru_unlink(struct rds_decoder_pool* pool, uint16_t idx) {
+  struct pool_station* station = &pool->stations[idx];
+  if (station->prev == NO_STATION)
+    pool->mru = station->next;
+  else
+    pool->stations[station->prev].next = station->next;
+  if (station->next == NO_STATION)
+    pool->lru = station->prev;
+  else
+    pool->stations[station->next].prev = station->prev;
+}
+
+static void lru_push_front(struct rds_decoder_pool* pool, uint16_t idx) {
+  struct pool_station* station = &pool->stations[idx];
+  station->prev = NO_STATION;
+  station->next = pool->mru;
+  if (pool->mru != NO_STATION)
+    pool->stations[pool->mru].prev = idx;
+  pool->mru = idx;
+  if (pool->lru == NO_STATION)
+    pool->lru = idx;
+}
+
+/**
+ * Return the index of a free station, with cleared data, evicting the least
+ * recently used station if all are in use.
+ */
+static uint16_t allocate_station(struct rds_decoder_pool* pool) {
+  if (pool->count < pool->config.capacity)
+    return pool->count++;
+
+  const uint16_t idx = pool->lru;
+  struct pool_station* station = &pool->stations[idx];
+  if (pool->config.evict_cb)
+    pool->config.evict_cb(&pool->data[idx], pool->config.cb_data);
+  remove_slot(pool, find_slot(pool, station->pi_code));
+  lru_unlink(pool, idx);
+  // The decoder has no ODA clear callback, so this only clears the data.
+  rds_decoder_reset(&pool->decoders[idx]);
+  return idx;
+}
+
+/**
+ * Return the PI code of the station which sent \p blocks.
+ *
+ * @return true if the group has a usable PI code.
+ */
+static bool group_pi_code(const struct rds_blocks* blocks, uint16_t* pi_code) {
+  if (blocks->a.errors <= BLERA_MAX) {
+    *pi_code = blocks->a.val;
+    return true;
+  }
+  // Version B groups repeat the PI code in block C.
+  if (blocks->b.errors <= BLERB_MAX && (blocks->b.val & 0x0800) &&
+      blocks->c.errors <= BLERC_MAX) {
+    *pi_code = blocks->c.val;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Return the index of the station with \p pi_code, adding it if necessary,
+ * and mark it as the most recently used.
+ */
+static uint16_t get_station(struct rds_decoder_pool* pool, uint16_t pi_code) {
+  // Stations usually send many groups in a row, so check the last first.
+  if (pool->mru != NO_STATION && pool->stations[pool->mru].pi_code == pi_code)
+    return pool->mru;
+
+  const uint32_t slot = find_slot(pool, pi_code);
+  uint16_t idx = pool->slots[slot];
+  if (idx != EMPTY_SLOT) {
+    lru_unlink(pool, idx);
+    lru_push_front(pool, idx);
+    return idx;
+  }
+
+  idx = allocate_station(pool);
+  struct pool_station* station = &pool->stations[idx];
+  station->pi_code = pi_code;
+  // Eviction may have moved entries, so find the slot again.
+  pool->slots[find_slot(pool, pi_code)] = idx;
+  lru_push_front(pool, idx);
+  return idx;
+}
+
+struct rds_decoder_pool* rds_decoder_pool_create(
+    const struct rds_decoder_pool_config* config) {
+  if (config->capacity == 0 || config->capacity == NO_STATION)
+    return NULL;
+
+  struct rds_decoder_pool* pool =
+      (struct rds_decoder_pool*)calloc(1, sizeof(struct rds_decoder_pool));
+  if (!pool)
+    return NULL;
+  pool->config = *config;
+  pool->mru = NO_STATION;
+  pool->lru = NO_STATION;
+
+  uint32_t num_slots = 4;
+  pool->slot_shift = 30;
+  while (num_slots < 2u * config->capacity) {
+    num_slots *= 2;
+    pool->slot_shift--;
+  }
+  pool->slot_mask = num_slots - 1;
+
+  pool->stations = (struct pool_station*)malloc(config->capacity *
+                                                sizeof(struct pool_station));
+  pool->decoders = (struct rds_decoder*)malloc(config->capacity *
+                                               sizeof(struct rds_decoder));
+  pool->data =
+      (struct rds_data*)malloc(config->capacity * sizeof(struct rds_data));
+  pool->slots = (uint16_t*)malloc(num_slots * sizeof(uint16_t));
+  if (!pool->stations || !pool->decoders || !pool->data || !pool->slots) {
+    rds_decoder_pool_delete(pool);
+    return NULL;
+  }
+  memset(pool->slots, 0xFF, num_slots * sizeof(uint16_t));
+
+  for (uint16_t i = 0; i < config->capacity; i++) {
+    struct rds_decoder* decoder = &pool->decoders[i];
+    const struct rds_decoder_config decoder_config = {
+        .advanced_ps_decoding = config->advanced_ps_decoding,
+        .rds_data = &pool->data[i],
+    };
+    rds_decoder_init(decoder, &decoder_config);
+    // No clear callback, as it couldn't identify the station. Hosts clear a
+    // station's ODA data when it is evicted (See EvictStationFunc).
+    rds_decoder_set_oda_callbacks(decoder, config->oda_decode_cb, NULL,
+                                  config->cb_data);
+    rds_decoder_reset(decoder);
+    rds_decoder_set_change_callback(decoder, config->change_cb,
+                                    config->cb_data);
+  }
+  return pool;
+}
+
+void rds_decoder_pool_delete(struct rds_decoder_pool* pool) {
+  if (!pool)
+    return;
+  free(pool->slots);
+  free(pool->data);
+  free(pool->decoders);
+  free(pool->stations);
+  free(pool);
+}
+
+const struct rds_data* rds_decoder_pool_decode(
+    struct rds_decoder_pool* pool,
+    const struct rds_blocks* blocks) {
+  uint16_t pi_code;
+  if (!group_pi_code(blocks, &pi_code))
+    return NULL;
+  const uint16_t idx = get_station(pool, pi_code);
+  rds_decoder_decode(&pool->decoders[idx], blocks);
+  return &pool->data[idx];
+}
+
+const struct rds_data* rds_decoder_pool_find(
+    const struct rds_decoder_pool* pool,
+    uint16_t pi_code) {
+  const uint16_t idx = pool->slots[find_slot(pool, pi_code)];
+  return idx == EMPTY_SLOT ? NULL : &pool->data[idx];
+}
+
+uint16_t rds_decoder_pool_count(const struct rds_decoder_pool* pool) {
+  return pool->count;
+}
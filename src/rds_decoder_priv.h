@@ -0,0 +1,59 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <rds_decoder.h>
+
+struct rds_decoder {
+  struct rds_data* rds;  ///< Decode blocks into this (not owned by lib.).
+  struct {
+    /**
+     * A pointer to a function to decode ODA block data.
+     *
+     * This can be null if the application does not intend to decode ODA data.
+     */
+    DecodeODAFunc decode_cb;
+
+    /**
+     * A pointer to a function to clear stored ODA data.
+     *
+     * This is generally called when tuning to new channels, or at other times
+     * when the RDS data is to be cleared.
+     */
+    ClearODAFunc clear_cb;
+
+    void* cb_data;            ///< User data passed to both callbacks.
+  } oda;                      ///< ODA decode callbacks.
+  struct {
+    ValuesChangedFunc cb;     ///< Called when decoding changes values.
+    void* cb_data;            ///< User data passed to the callback.
+  } change;                   ///< Change notification callback.
+  struct rds_snapshot* snapshot;  ///< Published to after changes (or NULL).
+  bool advanced_ps_decoding;  ///< Algorithm when decoding PS text.
+
+  /// The group handlers, indexed by group type code and version (the top
+  /// five bits of block B).
+  DecodeGroupFunc group_handlers[RDS_NUM_GROUP_TYPES];
+};
+
+/**
+ * Initialize a decoder in caller provided memory.
+ *
+ * This is the same as rds_decoder_create, but without the allocation.
+ */
+void rds_decoder_init(struct rds_decoder* decoder,
+                      const struct rds_decoder_config* config);
@@ -31,4 +31,12 @@
 
 #if !defined(CLEAR_BITS)
 #define CLEAR_BITS(value, bits) (value &= ~(bits))
-#endif
\ No newline at end of file
+#endif
+
+#if !defined(PREFETCH)
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH(addr) UNUSED(addr)
+#endif
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <rds_decoder.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A seqlock protected copy of an rds_data.
+ *
+ * The sequence number is odd while the copy is being written. Readers copy
+ * the data, and retry if the sequence number was odd or changed meanwhile.
+ */
+struct rds_snapshot {
+  uint32_t seq;          ///< The sequence number (accessed atomically).
+  struct rds_data data;  ///< The most recently published data.
+};
+
+struct rds_snapshot* rds_snapshot_create(void) {
+  // Zeroed data, with no values valid, is a consistent initial snapshot.
+  return (struct rds_snapshot*)calloc(1, sizeof(struct rds_snapshot));
+}
+
+void rds_snapshot_delete(struct rds_snapshot* snapshot) {
+  free(snapshot);
+}
+
+void rds_snapshot_publish(struct rds_snapshot* snapshot,
+                          const struct rds_data* rds) {
+  // Only the one writer modifies seq, so this needs no read-modify-write.
+  const uint32_t seq = __atomic_load_n(&snapshot->seq, __ATOMIC_RELAXED);
+  __atomic_store_n(&snapshot->seq, seq + 1, __ATOMIC_RELAXED);
+  // Readers must see the odd sequence number before any of the new data.
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy(&snapshot->data, rds, sizeof(snapshot->data));
+  __atomic_store_n(&snapshot->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+uint32_t rds_snapshot_read(const struct rds_snapshot* snapshot,
+                           struct rds_data* rds) {
+  while (true) {
+    const uint32_t seq = __atomic_load_n(&snapshot->seq, __ATOMIC_ACQUIRE);
+    if (seq & 1)
+      continue;  // Being written - the writer will finish shortly.
+    memcpy(rds, &snapshot->data, sizeof(*rds));
+    // The copy must complete before seq is checked again.
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&snapshot->seq, __ATOMIC_RELAXED) == seq)
+      return seq / 2;
+  }
+}
+
+uint32_t rds_snapshot_version(const struct rds_snapshot* snapshot) {
+  return __atomic_load_n(&snapshot->seq, __ATOMIC_ACQUIRE) / 2;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rt_text.h"
+
+// The Radiotext arrays are 64 bytes, so are processed 16 bytes at a time
+// where SSE2 or NEON is available. The scalar loops handle any remainder,
+// and everything on other targets.
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+void rt_fill_nulls(uint8_t* text, size_t len) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i space = _mm_set1_epi8(' ');
+  for (; i + 16 <= len; i += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)(text + i));
+    const __m128i nulls = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+    _mm_storeu_si128((__m128i*)(text + i),
+                     _mm_or_si128(v, _mm_and_si128(nulls, space)));
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t space = vdupq_n_u8(' ');
+  for (; i + 16 <= len; i += 16) {
+    const uint8x16_t v = vld1q_u8(text + i);
+    vst1q_u8(text + i, vbslq_u8(vceqq_u8(v, vdupq_n_u8(0)), space, v));
+  }
+#endif
+  for (; i < len; i++) {
+    if (!text[i])
+      text[i] = ' ';
+  }
+}
+
+void rt_decrement_counts(uint8_t* counts, size_t len) {
+  // max(count - 1, min(count, 1)) leaves zero and one alone, and decrements
+  // everything else, without any compares.
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i one = _mm_set1_epi8(1);
+  for (; i + 16 <= len; i += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)(counts + i));
+    _mm_storeu_si128(
+        (__m128i*)(counts + i),
+        _mm_max_epu8(_mm_subs_epu8(v, one), _mm_min_epu8(v, one)));
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t one = vdupq_n_u8(1);
+  for (; i + 16 <= len; i += 16) {
+    const uint8x16_t v = vld1q_u8(counts + i);
+    vst1q_u8(counts + i, vmaxq_u8(vqsubq_u8(v, one), vminq_u8(v, one)));
+  }
+#endif
+  for (; i < len; i++) {
+    if (counts[i] > 1)
+      counts[i]--;
+  }
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that every block line decoder supported by this CPU gives the same
+// results as the scalar decoder.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <initializer_list>
+
+#include <rds_decoder.h>
+#include "block_line_decoder.h"
+
+namespace {
+
+const int kRounds = 200000;
+
+const char* TypeName(BlockLineDecoderType type) {
+  switch (type) {
+    case BlockLineDecoderType::kScalar:
+      return "scalar";
+    case BlockLineDecoderType::kSSE2:
+      return "SSE2";
+    case BlockLineDecoderType::kAVX2:
+      return "AVX2";
+  }
+  return "?";
+}
+
+/**
+ * Return a random character for a block field: mostly hex digits (either
+ * case), with '-', other ASCII, and bytes with the high bit set.
+ */
+char RandomFieldChar() {
+  static const char kHex[] = "0123456789ABCDEFabcdef";
+  static const char kOther[] = "-gGzZ /:@`\t\n\x7f";
+  const int r = rand();
+  switch (r % 8) {
+    case 0:
+      return kOther[(r >> 3) % (sizeof(kOther) - 1)];
+    case 1:
+      return static_cast<char>(0x80 | ((r >> 3) & 0x7f));
+    default:
+      return kHex[(r >> 3) % (sizeof(kHex) - 1)];
+  }
+}
+
+/**
+ * Fill \p line with a random block line prefix. Some lines have missing
+ * ("----") fields, and some a broken layout.
+ */
+void RandomLine(char* line) {
+  for (size_t i = 0; i < kBlockLinePrefixLen; i++)
+    line[i] = RandomFieldChar();
+  for (int field = 0; field < 4; field++) {
+    char* f = line + field * 5;
+    if (rand() % 4 == 0) {
+      memcpy(f, "----", 4);
+    } else if (rand() % 2 == 0) {
+      // A valid field, in either case, so that most lines are valid.
+      for (int i = 0; i < 4; i++)
+        f[i] = "0123456789ABCDEFabcdef"[rand() % 22];
+    }
+    f[4] = ' ';
+  }
+  line[kBlockLinePrefixLen - 1] = '@';
+  if (rand() % 16 == 0)
+    line[rand() % kBlockLinePrefixLen] = RandomFieldChar();
+}
+
+bool SameBlock(const struct rds_block& a, const struct rds_block& b) {
+  return a.val == b.val && a.errors == b.errors;
+}
+
+bool SameBlocks(const struct rds_blocks& a, const struct rds_blocks& b) {
+  return SameBlock(a.a, b.a) && SameBlock(a.b, b.b) && SameBlock(a.c, b.c) &&
+         SameBlock(a.d, b.d);
+}
+
+}  // namespace
+
+int main() {
+  const BlockLineDecoder scalar =
+      GetBlockLineDecoder(BlockLineDecoderType::kScalar);
+  int failures = 0;
+  for (BlockLineDecoderType type :
+       {BlockLineDecoderType::kSSE2, BlockLineDecoderType::kAVX2}) {
+    const BlockLineDecoder decoder = GetBlockLineDecoder(type);
+    if (!decoder) {
+      printf("%s: not supported by this CPU, skipped\n", TypeName(type));
+      continue;
+    }
+    srand(1);
+    int valid = 0;
+    for (int round = 0; round < kRounds; round++) {
+      char line[kBlockLinePrefixLen];
+      RandomLine(line);
+      struct rds_blocks expected;
+      struct rds_blocks actual;
+      memset(&expected, 0, sizeof(expected));
+      memset(&actual, 0, sizeof(actual));
+      const bool expected_ok = scalar(line, &expected);
+      const bool actual_ok = decoder(line, &actual);
+      valid += expected_ok;
+      if (expected_ok != actual_ok ||
+          (expected_ok && !SameBlocks(expected, actual))) {
+        if (!failures) {
+          fprintf(stderr, "%s: mismatch on \"%.*s\"\n", TypeName(type),
+                  static_cast<int>(kBlockLinePrefixLen), line);
+        }
+        failures++;
+      }
+    }
+    printf("%s: %d lines (%d with the block line layout)\n", TypeName(type),
+           kRounds, valid);
+  }
+
+  if (failures) {
+    fprintf(stderr, "%d mismatches\n", failures);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that the SWAR Program Service hit count functions give the same
+// results as per-byte loops, for every pattern of counts.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ps_counts.h"
+
+#define NUM_COUNTS 8
+#define ROUNDS 200000
+
+static void decrement_counts_scalar(uint8_t* counts) {
+  for (int i = 0; i < NUM_COUNTS; i++) {
+    if (counts[i] > 1)
+      counts[i]--;
+  }
+}
+
+static bool counts_at_least_scalar(const uint8_t* counts, uint8_t n) {
+  for (int i = 0; i < NUM_COUNTS; i++) {
+    if (counts[i] < n)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Check both functions against the per-byte loops for \p counts, and every
+ * limit.
+ *
+ * @return The number of mismatches.
+ */
+static int check(const uint8_t* counts) {
+  int failures = 0;
+  uint8_t swar[NUM_COUNTS];
+  uint8_t scalar[NUM_COUNTS];
+  memcpy(swar, counts, sizeof(swar));
+  memcpy(scalar, counts, sizeof(scalar));
+  ps_decrement_counts(swar);
+  decrement_counts_scalar(scalar);
+  if (memcmp(swar, scalar, sizeof(swar)) != 0)
+    failures++;
+
+  for (uint8_t n = 1; n <= 127; n++) {
+    if (ps_counts_at_least(counts, n) != counts_at_least_scalar(counts, n))
+      failures++;
+  }
+
+  if (failures) {
+    fprintf(stderr, "mismatch for counts");
+    for (int i = 0; i < NUM_COUNTS; i++)
+      fprintf(stderr, " %u", counts[i]);
+    fprintf(stderr, "\n");
+  }
+  return failures;
+}
+
+int main(void) {
+  int failures = 0;
+  uint8_t counts[NUM_COUNTS];
+
+  // The decoder keeps each count in 0..3, so try all of those patterns.
+  for (uint32_t pattern = 0; pattern < (1u << (2 * NUM_COUNTS)); pattern++) {
+    for (int i = 0; i < NUM_COUNTS; i++)
+      counts[i] = (pattern >> (2 * i)) & 3;
+    failures += check(counts);
+  }
+
+  // Every 7 bit count in every position, with the others random, to catch
+  // borrows between neighboring counts.
+  srand(1);
+  for (int round = 0; round < ROUNDS; round++) {
+    for (int i = 0; i < NUM_COUNTS; i++)
+      counts[i] = rand() & 0x7F;
+    counts[round % NUM_COUNTS] = (round / NUM_COUNTS) & 0x7F;
+    failures += check(counts);
+  }
+
+  if (failures) {
+    fprintf(stderr, "%d mismatches\n", failures);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
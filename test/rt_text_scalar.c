@@ -0,0 +1,26 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The scalar build of rt_text.c, to check the SIMD build against. Its
+// functions are renamed so that both can be linked into one test.
+
+#undef __SSE2__
+#undef __ARM_NEON
+
+#define rt_fill_nulls rt_fill_nulls_scalar
+#define rt_decrement_counts rt_decrement_counts_scalar
+
+#include "rt_text.c"
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2020 Christopher Mumford
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that the SIMD (SSE2 or NEON) Radiotext functions give the same
+// results as the scalar loops, for every length a Radiotext can have.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rt_text.h"
+
+#define MAX_LEN 64
+#define ROUNDS 2000
+
+void rt_fill_nulls_scalar(uint8_t* text, size_t len);
+void rt_decrement_counts_scalar(uint8_t* counts, size_t len);
+
+/**
+ * Fill \p buf with random bytes, biased towards the interesting values
+ * (zero, one and 255).
+ */
+static void random_fill(uint8_t* buf, size_t len) {
+  static const uint8_t kEdges[] = {0, 1, 2, 0xFE, 0xFF};
+  for (size_t i = 0; i < len; i++) {
+    const int r = rand();
+    buf[i] = (r & 3) ? (uint8_t)(r >> 8) : kEdges[(r >> 8) % sizeof(kEdges)];
+  }
+}
+
+/**
+ * Run \p simd and \p scalar on the same random data of every length (and
+ * alignment), and check that they write the same bytes, and nothing past
+ * the end.
+ *
+ * @return The number of mismatches.
+ */
+static int compare(const char* name,
+                   void (*simd)(uint8_t*, size_t),
+                   void (*scalar)(uint8_t*, size_t)) {
+  int failures = 0;
+  for (size_t len = 0; len <= MAX_LEN; len++) {
+    for (size_t offset = 0; offset < 16; offset++) {
+      for (int round = 0; round < ROUNDS / 16; round++) {
+        uint8_t a[MAX_LEN + 32];
+        uint8_t b[MAX_LEN + 32];
+        random_fill(a, sizeof(a));
+        memcpy(b, a, sizeof(a));
+        simd(a + offset, len);
+        scalar(b + offset, len);
+        if (memcmp(a, b, sizeof(a)) != 0) {
+          if (!failures)
+            fprintf(stderr, "%s: mismatch at length %zu, offset %zu\n", name,
+                    len, offset);
+          failures++;
+        }
+      }
+    }
+  }
+  return failures;
+}
+
+int main(void) {
+  srand(1);
+  int failures = 0;
+  failures += compare("rt_fill_nulls", rt_fill_nulls, rt_fill_nulls_scalar);
+  failures += compare("rt_decrement_counts", rt_decrement_counts,
+                      rt_decrement_counts_scalar);
+
+  // Also every byte value, in every lane.
+  uint8_t a[256];
+  uint8_t b[256];
+  for (int shift = 0; shift < 16; shift++) {
+    for (int i = 0; i < 256; i++)
+      a[i] = b[i] = (uint8_t)(i + shift);
+    rt_decrement_counts(a, sizeof(a));
+    rt_decrement_counts_scalar(b, sizeof(b));
+    if (memcmp(a, b, sizeof(a)) != 0) {
+      fprintf(stderr, "rt_decrement_counts: mismatch on all byte values\n");
+      failures++;
+    }
+  }
+
+  if (failures) {
+    fprintf(stderr, "%d mismatches\n", failures);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
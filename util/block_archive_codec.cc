@@ -0,0 +1,183 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "block_archive_codec.h"
+
+#include <string.h>
+
+#include "byte_coding.h"
+
+namespace {
+
+// clang-format off
+#define SAME_MID   0x01  // Block B bits 5..10 match the prediction.
+#define SAME_A     0x02  // Block A matches the previous group.
+#define SAME_C     0x04  // Block C matches the prediction.
+#define SAME_D     0x08  // Block D matches the prediction.
+#define NO_ERRORS  0x10  // All blocks are BLER_NONE.
+#define SAME_DELTA 0x20  // Timestamp delta matches the previous group.
+// clang-format on
+
+uint8_t PackErrors(const struct rds_blocks& blocks) {
+  return (blocks.a.errors & 0x3) | (blocks.b.errors & 0x3) << 2 |
+         (blocks.c.errors & 0x3) << 4 | (blocks.d.errors & 0x3) << 6;
+}
+
+void UnpackErrors(uint8_t errors, struct rds_blocks* blocks) {
+  blocks->a.errors = errors & 0x3;
+  blocks->b.errors = (errors >> 2) & 0x3;
+  blocks->c.errors = (errors >> 4) & 0x3;
+  blocks->d.errors = (errors >> 6) & 0x3;
+}
+
+inline size_t ContextIndex(uint16_t b) {
+  return ((b >> 11) << 5) | (b & 0x1F);
+}
+
+}  // namespace
+
+size_t EncodeRawGroup(const struct rds_blocks& blocks,
+                      int64_t delta,
+                      uint8_t* buf) {
+  PutU16(buf + 0, blocks.a.val);
+  PutU16(buf + 2, blocks.b.val);
+  PutU16(buf + 4, blocks.c.val);
+  PutU16(buf + 6, blocks.d.val);
+  buf[8] = PackErrors(blocks);
+  return 9 + PutSignedVarint(buf + 9, delta);
+}
+
+const uint8_t* DecodeRawGroup(const uint8_t* pos,
+                              const uint8_t* end,
+                              struct rds_blocks* blocks,
+                              int64_t* delta) {
+  if (end - pos < 10)  // The smallest possible group.
+    return nullptr;
+
+  const uint8_t* next = GetSignedVarint(pos + 9, end, delta);
+  if (next == nullptr)
+    return nullptr;
+
+  blocks->a.val = GetU16(pos + 0);
+  blocks->b.val = GetU16(pos + 2);
+  blocks->c.val = GetU16(pos + 4);
+  blocks->d.val = GetU16(pos + 6);
+  UnpackErrors(pos[8], blocks);
+  return next;
+}
+
+PredictiveGroupCodec::PredictiveGroupCodec() : prev_a_(0), prev_delta_(0) {
+  memset(contexts_, 0, sizeof(contexts_));
+}
+
+size_t PredictiveGroupCodec::Encode(const struct rds_blocks& blocks,
+                                    int64_t delta,
+                                    uint8_t* buf) {
+  const uint16_t b = blocks.b.val;
+  const uint8_t mid = (b >> 5) & 0x3F;
+  const uint8_t errors = PackErrors(blocks);
+  Context* ctx = &contexts_[ContextIndex(b)];
+
+  uint8_t flags = 0;
+  size_t len = 2;
+  if (mid == ctx->mid)
+    flags |= SAME_MID;
+  else
+    buf[len++] = mid;
+  if (blocks.a.val == prev_a_) {
+    flags |= SAME_A;
+  } else {
+    PutU16(buf + len, blocks.a.val);
+    len += 2;
+  }
+  if (blocks.c.val == ctx->c) {
+    flags |= SAME_C;
+  } else {
+    PutU16(buf + len, blocks.c.val);
+    len += 2;
+  }
+  if (blocks.d.val == ctx->d) {
+    flags |= SAME_D;
+  } else {
+    PutU16(buf + len, blocks.d.val);
+    len += 2;
+  }
+  if (errors == 0)
+    flags |= NO_ERRORS;
+  else
+    buf[len++] = errors;
+  if (delta == prev_delta_)
+    flags |= SAME_DELTA;
+  else
+    len += PutSignedVarint(buf + len, delta);
+
+  buf[0] = (b & 0x1F) | (flags << 5);
+  buf[1] = (b >> 11) | ((flags >> 3) << 5);
+
+  ctx->mid = mid;
+  ctx->c = blocks.c.val;
+  ctx->d = blocks.d.val;
+  prev_a_ = blocks.a.val;
+  prev_delta_ = delta;
+  return len;
+}
+
+const uint8_t* PredictiveGroupCodec::Decode(const uint8_t* pos,
+                                            const uint8_t* end,
+                                            struct rds_blocks* blocks,
+                                            int64_t* delta) {
+  if (end - pos < 2)
+    return nullptr;
+
+  const uint8_t flags = (pos[0] >> 5) | ((pos[1] >> 5) << 3);
+  const uint16_t b_key = (pos[1] & 0x1F) << 11 | (pos[0] & 0x1F);
+  Context* ctx = &contexts_[ContextIndex(b_key)];
+
+  // The size of the fixed size fields which follow.
+  const size_t fixed_len = 2 + !(flags & SAME_MID) + 2 * !(flags & SAME_A) +
+                           2 * !(flags & SAME_C) + 2 * !(flags & SAME_D) +
+                           !(flags & NO_ERRORS);
+  if (static_cast<size_t>(end - pos) < fixed_len)
+    return nullptr;
+
+  pos += 2;
+  if (!(flags & SAME_MID))
+    ctx->mid = *pos++;
+  if (!(flags & SAME_A)) {
+    prev_a_ = GetU16(pos);
+    pos += 2;
+  }
+  if (!(flags & SAME_C)) {
+    ctx->c = GetU16(pos);
+    pos += 2;
+  }
+  if (!(flags & SAME_D)) {
+    ctx->d = GetU16(pos);
+    pos += 2;
+  }
+  UnpackErrors((flags & NO_ERRORS) ? 0 : *pos++, blocks);
+  if (!(flags & SAME_DELTA)) {
+    pos = GetSignedVarint(pos, end, &prev_delta_);
+    if (pos == nullptr)
+      return nullptr;
+  }
+
+  blocks->a.val = prev_a_;
+  blocks->b.val = b_key | (ctx->mid << 5);
+  blocks->c.val = ctx->c;
+  blocks->d.val = ctx->d;
+  *delta = prev_delta_;
+  return pos;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <rds_decoder.h>
+
+/**
+ * Encoders and decoders for the groups in a block archive.
+ *
+ * Each encoder writes a single group, and the change in timestamp since the
+ * previous group, to a buffer of at least kMaxEncodedGroupSize bytes. Each
+ * decoder reads it back, returning the position after the group or nullptr
+ * if the group is truncated.
+ */
+
+/// The largest possible encoded group, for any codec.
+const size_t kMaxEncodedGroupSize = 20;
+
+/**
+ * Encode a group with the raw codec (see rds_block_archive.h).
+ *
+ * @return The number of bytes written to \p buf.
+ */
+size_t EncodeRawGroup(const struct rds_blocks& blocks,
+                      int64_t delta,
+                      uint8_t* buf);
+
+/**
+ * Decode a group encoded by EncodeRawGroup.
+ */
+const uint8_t* DecodeRawGroup(const uint8_t* pos,
+                              const uint8_t* end,
+                              struct rds_blocks* blocks,
+                              int64_t* delta);
+
+/**
+ * The predictive group codec.
+ *
+ * Each group is predicted from the last group with the same group type and
+ * block B address bits (the low five bits, which hold the PS/RT segment
+ * address, RT A/B flag, etc.). Block A is predicted from the previous group
+ * (the PI code rarely changes), as is the timestamp delta. Only values which
+ * differ from the prediction are stored. Each group is encoded as:
+ *
+ *   size  value
+ *   ----  -----
+ *      1  Bits 0..4: block B bits 0..4. Bits 5..7: flags 0..2.
+ *      1  Bits 0..4: block B bits 11..15 (type and version).
+ *         Bits 5..7: flags 3..5.
+ *    0-1  Block B bits 5..10 (TP & PTY), unless kSameMid.
+ *    0-2  Block A, unless kSameA.
+ *    0-2  Block C, unless kSameC.
+ *    0-2  Block D, unless kSameD.
+ *    0-1  Error codes (as the raw codec), unless kNoErrors.
+ *   0-10  Timestamp delta (as the raw codec), unless kSameDelta.
+ *
+ * Because the encoder and decoder keep identical prediction state one
+ * instance must be used to encode (or decode) an entire archive, in order.
+ */
+class PredictiveGroupCodec {
+ public:
+  PredictiveGroupCodec();
+
+  /**
+   * Encode a group.
+   *
+   * @return The number of bytes written to \p buf.
+   */
+  size_t Encode(const struct rds_blocks& blocks, int64_t delta, uint8_t* buf);
+
+  /**
+   * Decode a group encoded by Encode.
+   */
+  const uint8_t* Decode(const uint8_t* pos,
+                        const uint8_t* end,
+                        struct rds_blocks* blocks,
+                        int64_t* delta);
+
+ private:
+  /**
+   * The most recent group values for one group type and address.
+   */
+  struct Context {
+    uint8_t mid;  ///< Block B bits 5..10.
+    uint16_t c;   ///< Block C.
+    uint16_t d;   ///< Block D.
+  };
+
+  Context contexts_[1 << 10];  ///< Indexed by block B bits 0..4 and 11..15.
+  uint16_t prev_a_;
+  int64_t prev_delta_;
+};
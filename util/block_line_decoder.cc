@@ -0,0 +1,271 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "block_line_decoder.h"
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * Set a block to the decoded value, or mark it as missing.
+ */
+inline void SetBlock(struct rds_block* block, uint16_t val, bool valid) {
+  block->val = valid ? val : 0;
+  block->errors = valid ? BLER_NONE : BLER_6_PLUS;
+}
+
+/**
+ * Convert an ASCII hex digit to its value.
+ *
+ * @return The digit value (0..15), or -1 if \p c is not a hex digit.
+ */
+inline int HexDigitValue(uint8_t c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  c |= 0x20;  // Fold to lower case.
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+/**
+ * Parse four hex characters (or "----") into a rds_block.
+ */
+struct rds_block ParseBlock(const char* text) {
+  const int d0 = HexDigitValue(text[0]);
+  const int d1 = HexDigitValue(text[1]);
+  const int d2 = HexDigitValue(text[2]);
+  const int d3 = HexDigitValue(text[3]);
+
+  struct rds_block block;
+  SetBlock(&block, (d0 << 12) | (d1 << 8) | (d2 << 4) | d3,
+           (d0 | d1 | d2 | d3) >= 0);
+  return block;
+}
+
+bool DecodeBlockLineScalar(const char* line, struct rds_blocks* blocks) {
+  // F202 2410 4652 414E @2019/05/04 02:29:17.94
+  if (line[4] != ' ' || line[9] != ' ' || line[14] != ' ' || line[19] != ' ' ||
+      line[20] != '@') {
+    return false;
+  }
+
+  blocks->a = ParseBlock(line + 0);
+  blocks->b = ParseBlock(line + 5);
+  blocks->c = ParseBlock(line + 10);
+  blocks->d = ParseBlock(line + 15);
+  return true;
+}
+
+#if defined(HAVE_X86_SIMD)
+
+// The line is loaded as two overlapping 16 byte vectors, one at offset 0 and
+// one at offset 5. This puts the hex fields (A,C and B,D) and the separators
+// at the same byte positions in both vectors:
+//
+//   byte:      0123456789012345
+//   line + 0:  F202 2410 4652 4
+//   line + 5:  2410 4652 414E @
+//
+// Fields are at bytes 0..3 and 10..13, separators at bytes 4, 9, and 14, and
+// the second vector has the '@' at byte 15.
+
+// clang-format off
+#define FIELD_LO_MASK 0x000F  // Movemask bits of the field at bytes 0..3.
+#define FIELD_HI_MASK 0x3C00  // Movemask bits of the field at bytes 10..13.
+#define SPACES_MASK   0x4210  // Movemask bits of the separators.
+#define AT_MASK       0x8000  // Movemask bit of the '@' (second vector only).
+// clang-format on
+
+/**
+ * Convert each byte of \p c from an ASCII hex digit to its value.
+ *
+ * @param c     The characters to convert.
+ * @param valid Set to 0xFF for each byte which is a hex digit, else 0x00.
+ *
+ * @return The digit values. Bytes which are not hex digits are zero.
+ */
+__attribute__((target("sse2"))) inline __m128i HexToNibblesSSE2(
+    __m128i c,
+    __m128i* valid) {
+  const __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+  const __m128i is_digit =
+      _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                    _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+  const __m128i is_alpha =
+      _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                    _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+  *valid = _mm_or_si128(is_digit, is_alpha);
+  return _mm_or_si128(
+      _mm_and_si128(is_digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+      _mm_and_si128(is_alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+/**
+ * Combine the nibbles at bytes 0..3 and 10..13 into two 16-bit values.
+ *
+ * @return The values in 32-bit lanes 0 and 1.
+ */
+__attribute__((target("sse2"))) inline __m128i NibblesToWordsSSE2(
+    __m128i nibbles) {
+  // Each 16-bit lane becomes the byte value of its two characters.
+  const __m128i bytes = _mm_or_si128(
+      _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+      _mm_srli_epi16(nibbles, 8));
+  // Bring the byte pairs of both fields into 32-bit lanes 0 and 1.
+  const __m128i pairs = _mm_unpacklo_epi32(bytes, _mm_srli_si128(bytes, 10));
+  return _mm_or_si128(
+      _mm_and_si128(_mm_slli_epi32(pairs, 8), _mm_set1_epi32(0xFF00)),
+      _mm_srli_epi32(pairs, 16));
+}
+
+__attribute__((target("sse2"))) bool DecodeBlockLineSSE2(
+    const char* line,
+    struct rds_blocks* blocks) {
+  const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line));
+  const __m128i v1 =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + 5));
+
+  const __m128i spaces = _mm_set1_epi8(' ');
+  const int sp0 = _mm_movemask_epi8(_mm_cmpeq_epi8(v0, spaces));
+  const int sp1 = _mm_movemask_epi8(_mm_cmpeq_epi8(v1, spaces));
+  const int at1 = _mm_movemask_epi8(_mm_cmpeq_epi8(v1, _mm_set1_epi8('@')));
+  if ((sp0 & SPACES_MASK) != SPACES_MASK || !(sp1 & 0x4000) || !(at1 & AT_MASK))
+    return false;
+
+  __m128i valid0, valid1;
+  const __m128i n0 = HexToNibblesSSE2(v0, &valid0);
+  const __m128i n1 = HexToNibblesSSE2(v1, &valid1);
+  const int ok0 = _mm_movemask_epi8(valid0);
+  const int ok1 = _mm_movemask_epi8(valid1);
+
+  uint32_t vals[4];  // A, C, B, D.
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(vals),
+                   _mm_unpacklo_epi64(NibblesToWordsSSE2(n0),
+                                      NibblesToWordsSSE2(n1)));
+
+  SetBlock(&blocks->a, vals[0], (ok0 & FIELD_LO_MASK) == FIELD_LO_MASK);
+  SetBlock(&blocks->b, vals[2], (ok1 & FIELD_LO_MASK) == FIELD_LO_MASK);
+  SetBlock(&blocks->c, vals[1], (ok0 & FIELD_HI_MASK) == FIELD_HI_MASK);
+  SetBlock(&blocks->d, vals[3], (ok1 & FIELD_HI_MASK) == FIELD_HI_MASK);
+  return true;
+}
+
+/**
+ * The AVX2 implementation of HexToNibblesSSE2.
+ */
+__attribute__((target("avx2"))) inline __m256i HexToNibblesAVX2(
+    __m256i c,
+    __m256i* valid) {
+  const __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+  const __m256i is_digit =
+      _mm256_andnot_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('9')),
+                          _mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)));
+  const __m256i is_alpha =
+      _mm256_andnot_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('f')),
+                          _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)));
+  *valid = _mm256_or_si256(is_digit, is_alpha);
+  return _mm256_or_si256(
+      _mm256_and_si256(is_digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+      _mm256_and_si256(is_alpha,
+                       _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+}
+
+/**
+ * The AVX2 implementation of DecodeBlockLineSSE2.
+ *
+ * Both 16 byte vectors are handled at once, one per 128-bit lane.
+ */
+__attribute__((target("avx2"))) bool DecodeBlockLineAVX2(
+    const char* line,
+    struct rds_blocks* blocks) {
+  const __m256i v = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(line))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + 5)), 1);
+
+  const uint32_t sp = static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '))));
+  const uint32_t at = static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('@'))));
+  const uint32_t kSpaces = SPACES_MASK | (0x4000 << 16);
+  if ((sp & kSpaces) != kSpaces || !(at & (AT_MASK << 16)))
+    return false;
+
+  __m256i valid;
+  const __m256i nibbles = HexToNibblesAVX2(v, &valid);
+  const uint32_t ok = static_cast<uint32_t>(_mm256_movemask_epi8(valid));
+
+  const __m256i bytes = _mm256_or_si256(
+      _mm256_slli_epi16(_mm256_and_si256(nibbles, _mm256_set1_epi16(0x00FF)),
+                        4),
+      _mm256_srli_epi16(nibbles, 8));
+  const __m256i pairs =
+      _mm256_unpacklo_epi32(bytes, _mm256_srli_si256(bytes, 10));
+  const __m256i words = _mm256_or_si256(
+      _mm256_and_si256(_mm256_slli_epi32(pairs, 8), _mm256_set1_epi32(0xFF00)),
+      _mm256_srli_epi32(pairs, 16));
+
+  uint32_t vals[8];  // A, C, x, x, B, D, x, x.
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(vals), words);
+
+  SetBlock(&blocks->a, vals[0], (ok & FIELD_LO_MASK) == FIELD_LO_MASK);
+  SetBlock(&blocks->b, vals[4],
+           ((ok >> 16) & FIELD_LO_MASK) == FIELD_LO_MASK);
+  SetBlock(&blocks->c, vals[1], (ok & FIELD_HI_MASK) == FIELD_HI_MASK);
+  SetBlock(&blocks->d, vals[5],
+           ((ok >> 16) & FIELD_HI_MASK) == FIELD_HI_MASK);
+  return true;
+}
+
+#endif  // defined(HAVE_X86_SIMD)
+
+}  // namespace
+
+BlockLineDecoder GetBlockLineDecoder(BlockLineDecoderType type) {
+  switch (type) {
+    case BlockLineDecoderType::kScalar:
+      return DecodeBlockLineScalar;
+    case BlockLineDecoderType::kSSE2:
+#if defined(HAVE_X86_SIMD)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("sse2"))
+        return DecodeBlockLineSSE2;
+#endif
+      return nullptr;
+    case BlockLineDecoderType::kAVX2:
+#if defined(HAVE_X86_SIMD)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+        return DecodeBlockLineAVX2;
+#endif
+      return nullptr;
+  }
+  return nullptr;
+}
+
+BlockLineDecoderType GetBestBlockLineDecoderType() {
+  if (GetBlockLineDecoder(BlockLineDecoderType::kAVX2))
+    return BlockLineDecoderType::kAVX2;
+  if (GetBlockLineDecoder(BlockLineDecoderType::kSSE2))
+    return BlockLineDecoderType::kSSE2;
+  return BlockLineDecoderType::kScalar;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <rds_decoder.h>
+
+/**
+ * The number of bytes at the start of an RDS Spy block line which hold the
+ * four block fields:
+ *
+ *   "F202 2410 4652 414E @"
+ */
+const size_t kBlockLinePrefixLen = 21;
+
+/**
+ * The available block line decoder implementations.
+ */
+enum class BlockLineDecoderType {
+  kScalar,  ///< Portable implementation, always available.
+  kSSE2,    ///< x86 SSE2 implementation.
+  kAVX2,    ///< x86 AVX2 implementation.
+};
+
+/**
+ * Decode the four block fields at the start of an RDS Spy block line.
+ *
+ * Each field is four hex characters, or "----" for a missing block. Any field
+ * which isn't four hex characters is returned as a missing block with a value
+ * of zero and an error count of BLER_6_PLUS. All implementations produce
+ * identical results.
+ *
+ * @param line   The start of the line. At least kBlockLinePrefixLen bytes
+ *               must be readable.
+ * @param blocks Populated with the decoded blocks if the line has the block
+ *               line layout.
+ *
+ * @return true if the line has the block line layout.
+ */
+typedef bool (*BlockLineDecoder)(const char* line, struct rds_blocks* blocks);
+
+/**
+ * Return the decoder of the given type.
+ *
+ * @return The decoder, or nullptr if \p type is not supported by this CPU.
+ */
+BlockLineDecoder GetBlockLineDecoder(BlockLineDecoderType type);
+
+/**
+ * Return the fastest decoder type supported by this CPU.
+ */
+BlockLineDecoderType GetBestBlockLineDecoderType();
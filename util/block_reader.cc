@@ -0,0 +1,38 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "block_reader.h"
+
+#include "rds_block_archive.h"
+#include "rds_spy_log_reader.h"
+
+namespace {
+
+template <typename T>
+std::unique_ptr<BlockReader> OpenReader(const std::string& path) {
+  T* reader = new T();
+  std::unique_ptr<BlockReader> owner(reader);
+  if (!reader->Open(path))
+    return nullptr;
+  return owner;
+}
+
+}  // namespace
+
+std::unique_ptr<BlockReader> OpenBlockReader(const std::string& path) {
+  if (IsBlockArchive(path))
+    return OpenReader<RdsBlockArchiveReader>(path);
+  return OpenReader<RdsSpyLogReader>(path);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <rds_decoder.h>
+
+/**
+ * A source of RDS groups read from a file.
+ */
+class BlockReader {
+ public:
+  virtual ~BlockReader() {}
+
+  /**
+   * Read the next group.
+   *
+   * @param blocks    Populated with the group's blocks.
+   * @param timestamp If not null, set to the time the group was received in
+   *                  milliseconds since the Unix epoch (zero if unknown).
+   *
+   * @return true if \p blocks was populated, false at the end of the file.
+   */
+  virtual bool Next(struct rds_blocks* blocks, int64_t* timestamp) = 0;
+};
+
+/**
+ * Open a file of RDS groups for reading.
+ *
+ * The file format (RDS Spy log or RDS block archive) is determined from the
+ * file contents.
+ *
+ * @param path The path to the file.
+ *
+ * @return The reader, or nullptr if the file could not be opened.
+ */
+std::unique_ptr<BlockReader> OpenBlockReader(const std::string& path);
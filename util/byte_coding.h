@@ -0,0 +1,78 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Little endian and varint encoding helpers for binary file formats.
+
+inline void PutU16(uint8_t* p, uint16_t val) {
+  p[0] = val & 0xFF;
+  p[1] = val >> 8;
+}
+
+inline void PutU64(uint8_t* p, uint64_t val) {
+  for (int i = 0; i < 8; i++)
+    p[i] = (val >> (i * 8)) & 0xFF;
+}
+
+inline uint16_t GetU16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+inline uint64_t GetU64(const uint8_t* p) {
+  uint64_t val = 0;
+  for (int i = 7; i >= 0; i--)
+    val = (val << 8) | p[i];
+  return val;
+}
+
+/**
+ * Write \p val as a zigzag encoded LEB128 varint.
+ *
+ * @return The number of bytes written (at most 10).
+ */
+inline size_t PutSignedVarint(uint8_t* p, int64_t val) {
+  uint64_t zz = (static_cast<uint64_t>(val) << 1) ^ (val >> 63);
+  size_t len = 0;
+  while (zz >= 0x80) {
+    p[len++] = (zz & 0x7F) | 0x80;
+    zz >>= 7;
+  }
+  p[len++] = zz;
+  return len;
+}
+
+/**
+ * Read a zigzag encoded LEB128 varint.
+ *
+ * @return The position after the varint, or nullptr if it is truncated.
+ */
+inline const uint8_t* GetSignedVarint(const uint8_t* p,
+                                      const uint8_t* end,
+                                      int64_t* val) {
+  uint64_t zz = 0;
+  for (int shift = 0; p < end && shift < 64; shift += 7) {
+    const uint8_t byte = *p++;
+    zz |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      *val = static_cast<int64_t>(zz >> 1) ^ -static_cast<int64_t>(zz & 1);
+      return p;
+    }
+  }
+  return nullptr;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mapped_file.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+// static
+const size_t MappedFile::kWindowSize;
+
+MappedFile::MappedFile() : data_(nullptr), size_(0), released_(nullptr) {}
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+bool MappedFile::Open(const std::string& path) {
+  Close();
+
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    perror(path.c_str());
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    perror(path.c_str());
+    close(fd);
+    return false;
+  }
+
+  if (st.st_size == 0) {
+    // Can't map an empty file, but it is still valid.
+    close(fd);
+    return true;
+  }
+
+  void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  // The mapping holds its own reference to the file.
+  if (addr == MAP_FAILED) {
+    perror(path.c_str());
+    return false;
+  }
+  // Files are read front to back, so ask for aggressive read-ahead.
+  madvise(addr, st.st_size, MADV_SEQUENTIAL);
+  madvise(addr, std::min(static_cast<size_t>(st.st_size), kWindowSize),
+          MADV_WILLNEED);
+
+  data_ = released_ = static_cast<const char*>(addr);
+  size_ = st.st_size;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_)
+    munmap(const_cast<char*>(data_), size_);
+  data_ = released_ = nullptr;
+  size_ = 0;
+}
+
+void MappedFile::AdvanceWindow(const char* pos) {
+  // madvise() fails (EINVAL) unless the address is page aligned.
+  const uintptr_t page_mask = ~(static_cast<uintptr_t>(getpagesize()) - 1);
+  const char* page = reinterpret_cast<const char*>(
+      reinterpret_cast<uintptr_t>(pos) & page_mask);
+
+  // Start reading the next window while this one is being processed.
+  if (pos < end()) {
+    const size_t length =
+        std::min(static_cast<size_t>(end() - page),
+                 kWindowSize + static_cast<size_t>(pos - page));
+    const int result = madvise(const_cast<char*>(page), length, MADV_WILLNEED);
+    assert(result == 0);
+    (void)result;
+  }
+
+  // Drop the pages already consumed so that the resident size stays
+  // constant regardless of the file size. Both ends must be page aligned.
+  if (page > released_) {
+    madvise(const_cast<char*>(released_), page - released_, MADV_DONTNEED);
+    released_ = page;
+  }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <stddef.h>
+
+/**
+ * A read-only memory mapping of an entire file.
+ *
+ * Files are expected to be read front to back. As a file is read the caller
+ * should report its position with Consumed() so that the next part of the
+ * file can be read ahead and the part already read can be released.
+ */
+class MappedFile {
+ public:
+  MappedFile();
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * Map the file at \p path into memory, replacing any current mapping.
+   *
+   * @return true if successful.
+   */
+  bool Open(const std::string& path);
+
+  /**
+   * Unmap the file (if mapped).
+   */
+  void Close();
+
+  /**
+   * Report that the file has been read up to \p pos.
+   *
+   * This is cheap to call often - work is only done once every window.
+   */
+  void Consumed(const char* pos) {
+    if (static_cast<size_t>(pos - released_) >= kWindowSize)
+      AdvanceWindow(pos);
+  }
+
+  /// The start of the file contents (nullptr if empty or not mapped).
+  const char* data() const { return data_; }
+
+  /// The number of bytes in the mapped file.
+  size_t size() const { return size_; }
+
+  /// The end of the file contents.
+  const char* end() const { return data_ + size_; }
+
+ private:
+  /// The amount of the file read ahead of (and released behind) the read
+  /// position.
+  static const size_t kWindowSize = 4 * 1024 * 1024;
+
+  void AdvanceWindow(const char* pos);
+
+  const char* data_;
+  size_t size_;
+  const char* released_;  ///< File pages before this have been released.
+};
@@ -0,0 +1,308 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mpx_demodulator.h"
+
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const int kBasebandRate = 19000;  // Eight samples per biphase symbol.
+const double kSubcarrierFreq = 57000;
+const double kCutoffFreq = 3200;      // Between the RDS band and L-R audio.
+const double kTransitionWidth = 1600;  // Passband to 2.4 kHz, stop at 4 kHz.
+const unsigned kSamplesPerSymbol = 8;
+
+// Loop gains, tuned on synthetic MPX at 171 and 228 kHz.
+const float kAgcRate = 0.001f;
+const float kCostasAlpha = 0.02f;
+const float kCostasBeta = 0.0001f;
+const float kGardnerGain = 0.5f;
+const float kBitEnergyDecay = 1.0f - 1.0f / 128;
+const float kLlrScale = 32;  // A clean bit's symbols differ by 2.0.
+
+float Clamp(float v, float limit) {
+  return v > limit ? limit : (v < -limit ? -limit : v);
+}
+
+void FilterScalar(const float* taps_i,
+                  const float* taps_q,
+                  const float* x,
+                  size_t n,
+                  float* out_i,
+                  float* out_q) {
+  float sum_i = 0;
+  float sum_q = 0;
+  for (size_t k = 0; k < n; k++) {
+    sum_i += taps_i[k] * x[k];
+    sum_q += taps_q[k] * x[k];
+  }
+  *out_i = sum_i;
+  *out_q = sum_q;
+}
+
+#if defined(HAVE_X86_SIMD)
+
+__attribute__((target("sse2"))) float HorizontalSumSSE2(__m128 v) {
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+  return _mm_cvtss_f32(v);
+}
+
+__attribute__((target("sse2"))) void FilterSSE2(const float* taps_i,
+                                                const float* taps_q,
+                                                const float* x,
+                                                size_t n,
+                                                float* out_i,
+                                                float* out_q) {
+  // Two accumulators per output hide the latency of the adds.
+  __m128 sum_i0 = _mm_setzero_ps();
+  __m128 sum_i1 = _mm_setzero_ps();
+  __m128 sum_q0 = _mm_setzero_ps();
+  __m128 sum_q1 = _mm_setzero_ps();
+  for (size_t k = 0; k < n; k += 8) {
+    const __m128 x0 = _mm_loadu_ps(x + k);
+    const __m128 x1 = _mm_loadu_ps(x + k + 4);
+    sum_i0 = _mm_add_ps(sum_i0, _mm_mul_ps(_mm_loadu_ps(taps_i + k), x0));
+    sum_i1 = _mm_add_ps(sum_i1, _mm_mul_ps(_mm_loadu_ps(taps_i + k + 4), x1));
+    sum_q0 = _mm_add_ps(sum_q0, _mm_mul_ps(_mm_loadu_ps(taps_q + k), x0));
+    sum_q1 = _mm_add_ps(sum_q1, _mm_mul_ps(_mm_loadu_ps(taps_q + k + 4), x1));
+  }
+  *out_i = HorizontalSumSSE2(_mm_add_ps(sum_i0, sum_i1));
+  *out_q = HorizontalSumSSE2(_mm_add_ps(sum_q0, sum_q1));
+}
+
+__attribute__((target("avx2"))) void FilterAVX2(const float* taps_i,
+                                                const float* taps_q,
+                                                const float* x,
+                                                size_t n,
+                                                float* out_i,
+                                                float* out_q) {
+  __m256 sum_i = _mm256_setzero_ps();
+  __m256 sum_q = _mm256_setzero_ps();
+  for (size_t k = 0; k < n; k += 8) {
+    const __m256 xk = _mm256_loadu_ps(x + k);
+    sum_i = _mm256_add_ps(sum_i, _mm256_mul_ps(_mm256_loadu_ps(taps_i + k), xk));
+    sum_q = _mm256_add_ps(sum_q, _mm256_mul_ps(_mm256_loadu_ps(taps_q + k), xk));
+  }
+  // Both horizontal sums at once: I in the low half, Q in the high half.
+  const __m256 halves = _mm256_hadd_ps(sum_i, sum_q);
+  const __m128 sums = _mm_add_ps(_mm256_castps256_ps128(halves),
+                                 _mm256_extractf128_ps(halves, 1));
+  *out_i = _mm_cvtss_f32(_mm_add_ss(sums, _mm_shuffle_ps(sums, sums, 1)));
+  *out_q = _mm_cvtss_f32(
+      _mm_add_ss(_mm_shuffle_ps(sums, sums, 2), _mm_shuffle_ps(sums, sums, 3)));
+}
+
+#endif  // defined(HAVE_X86_SIMD)
+
+}  // namespace
+
+MpxFilterKernel GetMpxFilterKernel(MpxKernelType type) {
+  switch (type) {
+    case MpxKernelType::kScalar:
+      return FilterScalar;
+    case MpxKernelType::kSSE2:
+#if defined(HAVE_X86_SIMD)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("sse2"))
+        return FilterSSE2;
+#endif
+      return nullptr;
+    case MpxKernelType::kAVX2:
+#if defined(HAVE_X86_SIMD)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+        return FilterAVX2;
+#endif
+      return nullptr;
+  }
+  return nullptr;
+}
+
+MpxKernelType GetBestMpxKernelType() {
+  if (GetMpxFilterKernel(MpxKernelType::kAVX2))
+    return MpxKernelType::kAVX2;
+  if (GetMpxFilterKernel(MpxKernelType::kSSE2))
+    return MpxKernelType::kSSE2;
+  return MpxKernelType::kScalar;
+}
+
+MpxDemodulator::MpxDemodulator(int sample_rate, MpxKernelType type)
+    : kernel_(GetMpxFilterKernel(type)),
+      decimation_(sample_rate / kBasebandRate),
+      next_output_(0),
+      phase_(0),
+      freq_(0),
+      amplitude_(1),
+      mf_i_(),
+      mf_q_(),
+      mf_sum_i_(0),
+      mf_sum_q_(0),
+      mf_pos_(0),
+      history_(),
+      history_pos_(0),
+      next_symbol_(kSamplesPerSymbol),
+      prev_symbol_(0),
+      energy_(),
+      symbol_count_(0),
+      prev_bit_(0) {
+  // A Hamming windowed sinc low pass filter, rounded up to a multiple of
+  // eight taps for the SIMD kernels.
+  size_t num_taps = static_cast<size_t>(3.3 * sample_rate / kTransitionWidth);
+  num_taps = (num_taps + 7) & ~static_cast<size_t>(7);
+  std::vector<double> lowpass(num_taps);
+  const double center = (num_taps - 1) / 2.0;
+  const double fc = kCutoffFreq / sample_rate;
+  double sum = 0;
+  for (size_t k = 0; k < num_taps; k++) {
+    const double t = k - center;
+    const double sinc = t == 0 ? 2 * fc : sin(2 * kPi * fc * t) / (kPi * t);
+    lowpass[k] = sinc * (0.54 - 0.46 * cos(2 * kPi * k / (num_taps - 1)));
+    sum += lowpass[k];
+  }
+
+  // Mixing with the subcarrier is folded into the taps. The filter output is
+  // only needed every decimation_ samples, which is a whole number of
+  // subcarrier cycles, so the mixer phase at each output is the same and
+  // the mixer can be applied to the taps rather than to every sample.
+  //
+  // The taps are stored reversed so that they line up with the oldest to
+  // newest samples of the filter window.
+  const double w = 2 * kPi * kSubcarrierFreq / sample_rate;
+  taps_i_.resize(num_taps);
+  taps_q_.resize(num_taps);
+  for (size_t k = 0; k < num_taps; k++) {
+    const size_t age = num_taps - 1 - k;
+    taps_i_[k] = static_cast<float>(lowpass[age] / sum * cos(w * age));
+    taps_q_[k] = static_cast<float>(lowpass[age] / sum * sin(w * age));
+  }
+}
+
+MpxDemodulator::~MpxDemodulator() = default;
+
+// static
+bool MpxDemodulator::IsValidSampleRate(int sample_rate) {
+  return sample_rate % kBasebandRate == 0 &&
+         sample_rate > 2 * kSubcarrierFreq + kBasebandRate;
+}
+
+void MpxDemodulator::Process(const float* samples,
+                             size_t count,
+                             std::vector<uint8_t>* bits) {
+  llrs_.clear();
+  ProcessSoft(samples, count, &llrs_);
+  for (int8_t llr : llrs_)
+    bits->push_back(llr > 0);
+}
+
+void MpxDemodulator::ProcessSoft(const float* samples,
+                                 size_t count,
+                                 std::vector<int8_t>* llrs) {
+  input_.insert(input_.end(), samples, samples + count);
+
+  const size_t num_taps = taps_i_.size();
+  while (next_output_ + num_taps <= input_.size()) {
+    float i, q;
+    kernel_(taps_i_.data(), taps_q_.data(), input_.data() + next_output_,
+            num_taps, &i, &q);
+    ProcessBaseband(i, q, llrs);
+    next_output_ += decimation_;
+  }
+
+  // Keep the samples still needed by the next filter window.
+  input_.erase(input_.begin(), input_.begin() + next_output_);
+  next_output_ = 0;
+}
+
+void MpxDemodulator::ProcessBaseband(float i,
+                                     float q,
+                                     std::vector<int8_t>* llrs) {
+  // Remove the carrier phase offset, leaving the data in the I channel.
+  const float c = cosf(phase_);
+  const float s = sinf(phase_);
+  const float zi = i * c + q * s;
+  const float zq = q * c - i * s;
+
+  mf_sum_i_ += zi - mf_i_[mf_pos_];
+  mf_sum_q_ += zq - mf_q_[mf_pos_];
+  mf_i_[mf_pos_] = zi;
+  mf_q_[mf_pos_] = zq;
+  mf_pos_ = (mf_pos_ + 1) % kSamplesPerSymbol;
+  const float mi = mf_sum_i_;
+  const float mq = mf_sum_q_;
+
+  amplitude_ += kAgcRate * (sqrtf(mi * mi + mq * mq) - amplitude_);
+  const float power = amplitude_ * amplitude_ + 1e-20f;
+
+  // Costas loop. The error is zero when the signal is entirely in I.
+  const float phase_error = Clamp(mi * mq / power, 1);
+  freq_ += kCostasBeta * phase_error;
+  phase_ += freq_ + kCostasAlpha * phase_error;
+  if (phase_ > kPi)
+    phase_ -= 2 * kPi;
+  else if (phase_ < -kPi)
+    phase_ += 2 * kPi;
+
+  history_[history_pos_] = mi;
+  history_pos_ = (history_pos_ + 1) % kSamplesPerSymbol;
+  next_symbol_ -= 1;
+  if (next_symbol_ > 0)
+    return;
+
+  // Interpolate the symbol, which fell between the last two samples, and the
+  // point half a symbol earlier.
+  const float f = next_symbol_;
+  auto sample = [this](unsigned age) {
+    return history_[(history_pos_ + kSamplesPerSymbol - 1 - age) %
+                    kSamplesPerSymbol];
+  };
+  const float symbol = sample(0) + f * (sample(0) - sample(1));
+  const float mid = sample(4) + f * (sample(4) - sample(5));
+
+  // Gardner timing error: the midpoint between symbols of opposite sign
+  // should be zero. It has the sign of the transition when sampling late.
+  const float timing_error = Clamp(mid * (symbol - prev_symbol_) / power, 1);
+  next_symbol_ += kSamplesPerSymbol - kGardnerGain * timing_error;
+  ProcessSymbol(symbol, llrs);
+}
+
+void MpxDemodulator::ProcessSymbol(float symbol, std::vector<int8_t>* llrs) {
+  // Each data bit is a pair of symbols of opposite sign. Which symbols pair
+  // up is found by comparing the average difference of each pairing - the
+  // right one always differs, the wrong one only when the bits change.
+  const float diff = prev_symbol_ - symbol;
+  const unsigned parity = symbol_count_++ & 1;
+  energy_[parity] = energy_[parity] * kBitEnergyDecay + fabsf(diff);
+  prev_symbol_ = symbol;
+  if (parity != (energy_[1] > energy_[0] ? 1u : 0u))
+    return;
+
+  // Differential decoding also removes the Costas loop's 180 degree phase
+  // ambiguity. The data bit is 1 if the two bits differ, and it is only as
+  // reliable as the less reliable of the two.
+  const float bit = diff / amplitude_;
+  float llr = fminf(fabsf(bit), fabsf(prev_bit_)) * kLlrScale;
+  if ((bit > 0) == (prev_bit_ > 0))
+    llr = -llr;
+  llrs->push_back(static_cast<int8_t>(Clamp(llr, INT8_MAX)));
+  prev_bit_ = bit;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The available implementations of the demodulator's filter kernel.
+ */
+enum class MpxKernelType {
+  kScalar,  ///< Portable implementation, always available.
+  kSSE2,    ///< x86 SSE2 implementation.
+  kAVX2,    ///< x86 AVX2 implementation.
+};
+
+/**
+ * Compute the I and Q outputs of a complex FIR filter with real input.
+ *
+ * @param taps_i The real part of the taps.
+ * @param taps_q The imaginary part of the taps.
+ * @param x      The input samples. All three arrays must be \p n long.
+ * @param n      The number of taps. Must be a multiple of 8.
+ * @param out_i  Set to the dot product of \p taps_i and \p x.
+ * @param out_q  Set to the dot product of \p taps_q and \p x.
+ */
+typedef void (*MpxFilterKernel)(const float* taps_i,
+                                const float* taps_q,
+                                const float* x,
+                                size_t n,
+                                float* out_i,
+                                float* out_q);
+
+/**
+ * Return the filter kernel of the given type.
+ *
+ * @return The kernel, or nullptr if \p type is not supported by this CPU.
+ */
+MpxFilterKernel GetMpxFilterKernel(MpxKernelType type);
+
+/**
+ * Return the fastest filter kernel type supported by this CPU.
+ */
+MpxKernelType GetBestMpxKernelType();
+
+/**
+ * Demodulates the RDS data bits from FM multiplex (MPX) samples.
+ *
+ * The 57 kHz RDS subcarrier is mixed down to baseband, low pass filtered
+ * and decimated to 19 kHz (eight samples per biphase symbol) in one step.
+ * A Costas loop then recovers the carrier phase, a matched filter and a
+ * Gardner loop recover the symbol clock, and pairs of biphase symbols are
+ * decoded, and differentially decoded, to data bits. The bits can be passed
+ * to an rds_bitstream to find the groups.
+ */
+class MpxDemodulator {
+ public:
+  /**
+   * @param sample_rate The MPX sample rate in Hz. See IsValidSampleRate().
+   * @param type        The filter kernel to use. This must be supported by
+   *                    this CPU.
+   */
+  MpxDemodulator(int sample_rate, MpxKernelType type);
+  ~MpxDemodulator();
+
+  /**
+   * Can MPX sampled at \p sample_rate be demodulated?
+   *
+   * The rate must be a multiple of 19 kHz, and at least 133 kHz (so that
+   * the 57 kHz subcarrier is below the Nyquist frequency). For example
+   * 171 kHz or 228 kHz.
+   */
+  static bool IsValidSampleRate(int sample_rate);
+
+  /**
+   * Demodulate the next MPX samples.
+   *
+   * @param samples The samples, scaled to about +/-1.0 at full deviation.
+   * @param count   The number of samples.
+   * @param bits    The demodulated data bits (each 0 or 1) are appended to
+   *                this.
+   */
+  void Process(const float* samples, size_t count, std::vector<uint8_t>* bits);
+
+  /**
+   * Demodulate the next MPX samples to soft decisions.
+   *
+   * @param samples The samples, scaled to about +/-1.0 at full deviation.
+   * @param count   The number of samples.
+   * @param llrs    The log-likelihood ratio of each demodulated data bit
+   *                (positive for a 1, about 64 for a clean signal) is
+   *                appended to this. See rds_bitstream_push_soft_bits().
+   */
+  void ProcessSoft(const float* samples,
+                   size_t count,
+                   std::vector<int8_t>* llrs);
+
+ private:
+  void ProcessBaseband(float i, float q, std::vector<int8_t>* llrs);
+  void ProcessSymbol(float symbol, std::vector<int8_t>* llrs);
+
+  const MpxFilterKernel kernel_;
+  const size_t decimation_;  ///< MPX samples per baseband sample.
+  std::vector<float> taps_i_;
+  std::vector<float> taps_q_;
+  std::vector<float> input_;  ///< Samples not yet fully filtered.
+  size_t next_output_;  ///< Offset in input_ of the next filter window.
+
+  // Carrier recovery (Costas loop).
+  float phase_;
+  float freq_;
+  float amplitude_;
+
+  // Matched filter, a moving sum over one symbol.
+  float mf_i_[8];
+  float mf_q_[8];
+  float mf_sum_i_;
+  float mf_sum_q_;
+  unsigned mf_pos_;
+
+  // Symbol clock recovery (Gardner loop).
+  float history_[8];  ///< Recent matched filter outputs.
+  unsigned history_pos_;
+  float next_symbol_;  ///< Samples until the next symbol.
+  float prev_symbol_;
+
+  // Biphase decoding.
+  float energy_[2];  ///< Average bit energy with each symbol pairing.
+  unsigned symbol_count_;
+  float prev_bit_;  ///< Soft value of the last (differentially encoded) bit.
+  std::vector<int8_t> llrs_;  ///< Used by Process().
+};
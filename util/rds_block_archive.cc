@@ -0,0 +1,160 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "rds_block_archive.h"
+
+#include <string.h>
+
+#include "byte_coding.h"
+
+bool IsBlockArchive(const std::string& path) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (f == nullptr)
+    return false;
+  char magic[sizeof(kBlockArchiveMagic)];
+  const bool is_archive =
+      fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+      memcmp(magic, kBlockArchiveMagic, sizeof(magic)) == 0;
+  fclose(f);
+  return is_archive;
+}
+
+RdsBlockArchiveWriter::RdsBlockArchiveWriter()
+    : file_(nullptr),
+      codec_(BlockArchiveCodec::kRaw),
+      group_count_(0),
+      first_timestamp_(0),
+      prev_timestamp_(0) {}
+
+RdsBlockArchiveWriter::~RdsBlockArchiveWriter() {
+  Close();
+}
+
+bool RdsBlockArchiveWriter::Open(const std::string& path,
+                                 BlockArchiveCodec codec) {
+  Close();
+
+  file_ = fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    perror(path.c_str());
+    return false;
+  }
+  setvbuf(file_, nullptr, _IOFBF, 1024 * 1024);
+  codec_ = codec;
+  predictive_codec_.reset(new PredictiveGroupCodec());
+  group_count_ = 0;
+  first_timestamp_ = prev_timestamp_ = 0;
+
+  // The header is rewritten, with the final values, when closed.
+  return WriteHeader();
+}
+
+bool RdsBlockArchiveWriter::Write(const struct rds_blocks& blocks,
+                                  int64_t timestamp) {
+  if (group_count_ == 0)
+    first_timestamp_ = prev_timestamp_ = timestamp;
+
+  uint8_t buf[kMaxEncodedGroupSize];
+  const int64_t delta = timestamp - prev_timestamp_;
+  const size_t len = codec_ == BlockArchiveCodec::kPredictive
+                         ? predictive_codec_->Encode(blocks, delta, buf)
+                         : EncodeRawGroup(blocks, delta, buf);
+  prev_timestamp_ = timestamp;
+
+  if (fwrite(buf, 1, len, file_) != len) {
+    perror("Error writing block archive");
+    return false;
+  }
+  group_count_++;
+  return true;
+}
+
+bool RdsBlockArchiveWriter::Close() {
+  if (file_ == nullptr)
+    return true;
+
+  bool ok = fseek(file_, 0, SEEK_SET) == 0 && WriteHeader();
+  if (fclose(file_) != 0)
+    ok = false;
+  file_ = nullptr;
+  if (!ok)
+    perror("Error writing block archive");
+  return ok;
+}
+
+bool RdsBlockArchiveWriter::WriteHeader() {
+  uint8_t header[kBlockArchiveHeaderSize];
+  memcpy(header, kBlockArchiveMagic, sizeof(kBlockArchiveMagic));
+  PutU16(header + 4, kBlockArchiveVersion);
+  PutU16(header + 6, static_cast<uint16_t>(codec_));
+  PutU64(header + 8, group_count_);
+  PutU64(header + 16, static_cast<uint64_t>(first_timestamp_));
+  return fwrite(header, 1, sizeof(header), file_) == sizeof(header);
+}
+
+RdsBlockArchiveReader::RdsBlockArchiveReader()
+    : codec_(BlockArchiveCodec::kRaw),
+      pos_(nullptr),
+      end_(nullptr),
+      prev_timestamp_(0) {}
+
+RdsBlockArchiveReader::~RdsBlockArchiveReader() = default;
+
+bool RdsBlockArchiveReader::Open(const std::string& path) {
+  if (!file_.Open(path))
+    return false;
+
+  const uint8_t* header = reinterpret_cast<const uint8_t*>(file_.data());
+  if (file_.size() < kBlockArchiveHeaderSize ||
+      memcmp(header, kBlockArchiveMagic, sizeof(kBlockArchiveMagic)) != 0) {
+    fprintf(stderr, "%s: not a block archive\n", path.c_str());
+    return false;
+  }
+  const uint16_t codec = GetU16(header + 6);
+  if (GetU16(header + 4) != kBlockArchiveVersion ||
+      codec > static_cast<uint16_t>(BlockArchiveCodec::kPredictive)) {
+    fprintf(stderr, "%s: unsupported block archive version\n", path.c_str());
+    return false;
+  }
+
+  codec_ = static_cast<BlockArchiveCodec>(codec);
+  predictive_codec_.reset(new PredictiveGroupCodec());
+
+  prev_timestamp_ = static_cast<int64_t>(GetU64(header + 16));
+  pos_ = header + kBlockArchiveHeaderSize;
+  end_ = header + file_.size();
+  return true;
+}
+
+bool RdsBlockArchiveReader::Next(struct rds_blocks* blocks,
+                                 int64_t* timestamp) {
+  int64_t delta;
+  const uint8_t* next =
+      codec_ == BlockArchiveCodec::kPredictive
+          ? predictive_codec_->Decode(pos_, end_, blocks, &delta)
+          : DecodeRawGroup(pos_, end_, blocks, &delta);
+  if (next == nullptr) {
+    pos_ = end_;  // End of (or truncated) archive.
+    return false;
+  }
+
+  prev_timestamp_ += delta;
+  if (timestamp)
+    *timestamp = prev_timestamp_;
+
+  pos_ = next;
+  file_.Consumed(reinterpret_cast<const char*>(pos_));
+  return true;
+}
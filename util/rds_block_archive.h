@@ -0,0 +1,157 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <rds_decoder.h>
+#include "block_archive_codec.h"
+#include "block_reader.h"
+#include "mapped_file.h"
+
+/**
+ * RDS block archive file format.
+ *
+ * A compact binary alternative to RDS Spy logs. All values are little endian.
+ *
+ * The file starts with a fixed size header:
+ *
+ *   offset  size  value
+ *   ------  ----  -----
+ *        0     4  Magic value (kBlockArchiveMagic).
+ *        4     2  Format version (kBlockArchiveVersion).
+ *        6     2  Codec used to encode the groups (BlockArchiveCodec).
+ *        8     8  Number of groups in the archive.
+ *       16     8  Timestamp of the first group (ms since the Unix epoch).
+ *
+ * Which is followed by each group. With the raw codec each group is:
+ *
+ *   size  value
+ *   ----  -----
+ *      8  Values of blocks A, B, C, and D (uint16 each).
+ *      1  Error codes (BLER_*), two bits per block: A in bits 0..1, B in
+ *         bits 2..3, C in bits 4..5, and D in bits 6..7.
+ *    1-10 The change in timestamp from the previous group in ms, as a
+ *         zigzag encoded LEB128 varint.
+ *
+ * The predictive codec is described in block_archive_codec.h.
+ */
+
+/// The value in the first four bytes of every RDS block archive.
+const char kBlockArchiveMagic[4] = {'R', 'D', 'S', 'A'};
+
+/// The current block archive format version.
+const uint16_t kBlockArchiveVersion = 1;
+
+/// The size of the block archive header.
+const size_t kBlockArchiveHeaderSize = 24;
+
+/**
+ * The encodings of the groups in a block archive.
+ */
+enum class BlockArchiveCodec : uint16_t {
+  kRaw = 0,         ///< Each group stored as-is.
+  kPredictive = 1,  ///< Groups stored as differences from a prediction.
+};
+
+/**
+ * Does the file at \p path start with the block archive magic value?
+ */
+bool IsBlockArchive(const std::string& path);
+
+/**
+ * Writes RDS groups to a block archive.
+ */
+class RdsBlockArchiveWriter {
+ public:
+  RdsBlockArchiveWriter();
+  ~RdsBlockArchiveWriter();
+
+  RdsBlockArchiveWriter(const RdsBlockArchiveWriter&) = delete;
+  RdsBlockArchiveWriter& operator=(const RdsBlockArchiveWriter&) = delete;
+
+  /**
+   * Create (or truncate) the archive at \p path.
+   *
+   * @param path  The path to the archive.
+   * @param codec The codec used to encode the groups.
+   *
+   * @return true if successful.
+   */
+  bool Open(const std::string& path, BlockArchiveCodec codec);
+
+  /**
+   * Append a group to the archive.
+   *
+   * @param blocks    The group's blocks.
+   * @param timestamp The time the group was received (ms since the epoch).
+   *
+   * @return true if successful.
+   */
+  bool Write(const struct rds_blocks& blocks, int64_t timestamp);
+
+  /**
+   * Finish writing the archive. Must be called for the archive to be valid.
+   *
+   * @return true if successful.
+   */
+  bool Close();
+
+  /// The number of groups written.
+  uint64_t group_count() const { return group_count_; }
+
+ private:
+  bool WriteHeader();
+
+  FILE* file_;
+  BlockArchiveCodec codec_;
+  std::unique_ptr<PredictiveGroupCodec> predictive_codec_;
+  uint64_t group_count_;
+  int64_t first_timestamp_;
+  int64_t prev_timestamp_;
+};
+
+/**
+ * Reads RDS groups from a block archive.
+ */
+class RdsBlockArchiveReader : public BlockReader {
+ public:
+  RdsBlockArchiveReader();
+  ~RdsBlockArchiveReader() override;
+
+  /**
+   * Open the archive at \p path for reading.
+   *
+   * @return true if successful.
+   */
+  bool Open(const std::string& path);
+
+  // BlockReader:
+  bool Next(struct rds_blocks* blocks, int64_t* timestamp) override;
+
+ private:
+  MappedFile file_;
+  BlockArchiveCodec codec_;
+  std::unique_ptr<PredictiveGroupCodec> predictive_codec_;
+  const uint8_t* pos_;  ///< The next group to read.
+  const uint8_t* end_;  ///< The end of the archive.
+  int64_t prev_timestamp_;
+};
@@ -15,112 +15,330 @@
 
 #include "rds_spy_log_reader.h"
 
-#include <stdlib.h>
-#include <string.h>
-
-#include <memory>
+#include <ctype.h>
+#include <stdio.h>
 
 #include <rds_decoder.h>
-
-#if !defined(ARRAY_SIZE)
-#define ARRAY_SIZE(ARRAY) (sizeof(ARRAY) / sizeof((ARRAY)[0]))
-#endif
+#include "block_line_decoder.h"
 
 namespace {
 
 /**
- * Parse a block string into a rds_block.
+ * The estimated average length of a block line. Only used to size buffers.
  *
- * The text is four hex characters or the special string "----" indicating
- * a missing block.
+ * F202 2410 4652 414E @2019/05/04 02:29:17.94
+ */
+const size_t kEstimatedLineLen = 44;
+
+/**
+ * Parse the two digit decimal number at \p text.
  *
- * @param text The input string.
+ * @return The value, or -1 if \p text isn't two digits.
+ */
+inline int ParseTwoDigits(const char* text) {
+  const unsigned hi = text[0] - '0';
+  const unsigned lo = text[1] - '0';
+  if (hi > 9 || lo > 9)
+    return -1;
+  return hi * 10 + lo;
+}
+
+/**
+ * Return the number of days from 1970-01-01 to the given date.
  *
- * @return The parsed block.
+ * This is the "days_from_civil" algorithm by Howard Hinnant, valid for all
+ * dates in the proleptic Gregorian calendar.
  */
-struct rds_block ParseBlock(const char* text) {
-  struct rds_block block;
+int64_t DaysFromCivil(int y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  const int era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return static_cast<int64_t>(era) * 146097 + static_cast<int64_t>(doe) -
+         719468;
+}
 
-  if (strcmp(text, "----") == 0) {
-    block.val = 0;
-    block.errors = BLER_6_PLUS;
-  } else {
-    block.val = strtol(text, nullptr, 16);
-    block.errors = BLER_NONE;
-  }
-  return block;
+/**
+ * Return the length of \p line once trailing whitespace is removed.
+ */
+size_t TrimmedLength(const char* line, size_t len) {
+  while (len && isspace((unsigned char)line[len - 1]))
+    len--;
+  return len;
+}
+
+/**
+ * Return the end of the line starting at \p pos.
+ *
+ * Lines end at "\n", "\r\n" or a lone "\r", so logs with mixed line endings
+ * are split into the correct lines.
+ */
+const char* FindLineEnd(const char* pos, const char* end) {
+  // Lines are short, so a single pass over this line beats searching for
+  // each terminator (which may be far away, or absent) separately.
+  while (pos < end && *pos != '\n' && *pos != '\r')
+    pos++;
+  // The '\n' of a "\r\n" terminator ends the line.
+  if (pos + 1 < end && pos[0] == '\r' && pos[1] == '\n')
+    pos++;
+  return pos;
+}
+
+/**
+ * Is the line (with trailing whitespace removed) expected in a log, but not
+ * a block line? These are blank lines and "<tag=value>" header lines.
+ */
+bool IsNonBlockLine(const char* line, size_t len) {
+  return len == 0 || line[0] == '<';
 }
 
 /**
- * Trim the whitespace on the end of the string.
+ * Does \p blocks have one or more missing blocks?
  */
-void rtrim(char* str) {
-  char* end = str + strlen(str) - 1;
-  while (str <= end && isspace((unsigned char)*end))
-    end--;
-  end[1] = '\0';
+bool IsPartialGroup(const struct rds_blocks& blocks) {
+  return blocks.a.errors == BLER_6_PLUS || blocks.b.errors == BLER_6_PLUS ||
+         blocks.c.errors == BLER_6_PLUS || blocks.d.errors == BLER_6_PLUS;
 }
 
-bool appears_to_be_block_line(const char* line) {
+/**
+ * Parse a single line of an RDS Spy log.
+ *
+ * @param line      The start of the line.
+ * @param len       The line length, not including the line terminator or
+ *                  any trailing whitespace.
+ * @param decoder   The decoder used to decode the line's block fields.
+ * @param blocks    Populated with the parsed blocks.
+ * @param timestamp If not null, populated with the parsed timestamp (zero if
+ *                  the timestamp is invalid).
+ *
+ * @return true if the line is a block line.
+ */
+bool ParseBlockLine(const char* line,
+                    size_t len,
+                    BlockLineDecoder decoder,
+                    struct rds_blocks* blocks,
+                    int64_t* timestamp) {
+  // The block fields are followed by a timestamp:
+  //
   // F202 2410 4652 414E @2019/05/04 02:29:17.94
   // F202 2410 4652 414E @2019/05/04 02:29:17.940
-  if (strlen(line) < 22)
-    return false;
-
-  if (line[4] != ' ')
+  if (len <= kBlockLinePrefixLen)
     return false;
-  if (line[9] != ' ')
+  if (!decoder(line, blocks))
     return false;
-  if (line[14] != ' ')
+  if (timestamp &&
+      !ParseRdsSpyTimestamp(line + kBlockLinePrefixLen,
+                            len - kBlockLinePrefixLen, timestamp)) {
+    *timestamp = 0;
+  }
+  return true;
+}
+
+/**
+ * Find and parse the next block line in the buffer.
+ *
+ * Malformed lines are counted and skipped, and parsing resumes at the
+ * following line.
+ *
+ * @param pos       The start of the first line to examine.
+ * @param end       The end of the buffer.
+ * @param decoder   The decoder used to decode block fields.
+ * @param blocks    Populated with the parsed blocks.
+ * @param timestamp If not null, populated with the parsed timestamp.
+ * @param counters  Updated with the lines examined.
+ *
+ * @return The start of the line following the parsed block line, or nullptr
+ *         if there are no more block lines before \p end.
+ */
+const char* ParseNextBlockLine(const char* pos,
+                               const char* end,
+                               BlockLineDecoder decoder,
+                               struct rds_blocks* blocks,
+                               int64_t* timestamp,
+                               RdsSpyParseCounters* counters) {
+  while (pos < end) {
+    const char* eol = FindLineEnd(pos, end);
+    const size_t len = TrimmedLength(pos, eol - pos);
+
+    if (ParseBlockLine(pos, len, decoder, blocks, timestamp)) {
+      counters->lines_parsed++;
+      if (IsPartialGroup(*blocks))
+        counters->partial_blocks++;
+      return eol < end ? eol + 1 : end;
+    }
+    if (!IsNonBlockLine(pos, len))
+      counters->lines_rejected++;
+    pos = eol + 1;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+RdsSpyParseCounters& RdsSpyParseCounters::operator+=(
+    const RdsSpyParseCounters& other) {
+  lines_parsed += other.lines_parsed;
+  lines_rejected += other.lines_rejected;
+  partial_blocks += other.partial_blocks;
+  return *this;
+}
+
+size_t ParseRdsSpyData(const char* data,
+                       size_t size,
+                       std::vector<struct rds_blocks>* blocks,
+                       RdsSpyParseCounters* counters) {
+  RdsSpyParseCounters unused_counters;
+  if (counters == nullptr)
+    counters = &unused_counters;
+
+  const size_t start_count = blocks->size();
+  blocks->reserve(start_count + size / kEstimatedLineLen);
+
+  const char* const end = data + size;
+  const BlockLineDecoder decoder =
+      GetBlockLineDecoder(GetBestBlockLineDecoderType());
+  struct rds_blocks blk;
+  while ((data = ParseNextBlockLine(data, end, decoder, &blk, nullptr,
+                                    counters))) {
+    blocks->push_back(blk);
+  }
+
+  return blocks->size() - start_count;
+}
+
+RdsSpyLogReader::RdsSpyLogReader()
+    : decoder_(GetBlockLineDecoder(GetBestBlockLineDecoderType())),
+      pos_(nullptr) {}
+
+RdsSpyLogReader::~RdsSpyLogReader() = default;
+
+bool RdsSpyLogReader::Open(const std::string& path) {
+  if (!file_.Open(path))
     return false;
-  if (line[19] != ' ')
+  pos_ = file_.data();
+  return true;
+}
+
+bool RdsSpyLogReader::Next(struct rds_blocks* blocks, int64_t* timestamp) {
+  if (pos_ == nullptr)
     return false;
-  if (line[20] != '@')
+
+  pos_ = ParseNextBlockLine(pos_, file_.end(), decoder_, blocks, timestamp,
+                            &counters_);
+  if (pos_ == nullptr)
     return false;
+
+  file_.Consumed(pos_);
   return true;
 }
 
-}  // namespace
+RdsSpyBufferReader::RdsSpyBufferReader(const char* data, size_t size)
+    : decoder_(GetBlockLineDecoder(GetBestBlockLineDecoderType())),
+      pos_(data),
+      end_(data + size) {}
 
-//
-// This is a very simple implementation of this file read operation. It is
-// *not* tolerant of file formatting errors.
-//
-bool LoadRdsSpyFile(const std::string& path,
-                    std::vector<struct rds_blocks>* blocks) {
-  FILE* f = fopen(path.c_str(), "r");
-  if (f == nullptr) {
-    perror("Error reading rds-spy file.");
+RdsSpyBufferReader::~RdsSpyBufferReader() = default;
+
+bool RdsSpyBufferReader::Next(struct rds_blocks* blocks, int64_t* timestamp) {
+  if (pos_ == nullptr)
     return false;
+  pos_ = ParseNextBlockLine(pos_, end_, decoder_, blocks, timestamp,
+                            &counters_);
+  return pos_ != nullptr;
+}
+
+RdsSpyStreamReader::RdsSpyStreamReader()
+    : decoder_(GetBlockLineDecoder(GetBestBlockLineDecoderType())),
+      pos_(0),
+      complete_end_(0) {}
+
+RdsSpyStreamReader::~RdsSpyStreamReader() = default;
+
+void RdsSpyStreamReader::Append(const char* data, size_t size) {
+  // Discard the consumed lines once they are the bulk of the buffer, so the
+  // buffer only ever holds about one read's worth of data.
+  if (pos_ > buffer_.size() / 2) {
+    buffer_.erase(0, pos_);
+    complete_end_ -= pos_;
+    pos_ = 0;
   }
+  buffer_.append(data, size);
 
-  char line[120];
-  while (fgets(line, ARRAY_SIZE(line), f) != nullptr) {
-    line[ARRAY_SIZE(line) - 1] = '\0';
-    rtrim(line);
-    if (appears_to_be_block_line(line)) {
-      struct rds_blocks blk;
+  // Only the new data needs to be searched for the last line terminator.
+  for (size_t i = buffer_.size(); i > buffer_.size() - size; i--) {
+    if (buffer_[i - 1] == '\n' || buffer_[i - 1] == '\r') {
+      complete_end_ = i;
+      break;
+    }
+  }
+}
 
-      char hex[5];
-      hex[4] = '\0';
+void RdsSpyStreamReader::Finish() {
+  complete_end_ = buffer_.size();
+}
 
-      memcpy(hex, line + 0, 4);
-      blk.a = ParseBlock(hex);
+bool RdsSpyStreamReader::Next(struct rds_blocks* blocks, int64_t* timestamp) {
+  if (pos_ >= complete_end_)
+    return false;
 
-      memcpy(hex, line + 5, 4);
-      blk.b = ParseBlock(hex);
+  const char* start = buffer_.data();
+  const char* next =
+      ParseNextBlockLine(start + pos_, start + complete_end_, decoder_, blocks,
+                         timestamp, &counters_);
+  if (next == nullptr) {
+    pos_ = complete_end_;
+    return false;
+  }
+  pos_ = next - start;
+  return true;
+}
 
-      memcpy(hex, line + 10, 4);
-      blk.c = ParseBlock(hex);
+bool LoadRdsSpyFile(const std::string& path,
+                    std::vector<struct rds_blocks>* blocks) {
+  MappedFile file;
+  if (!file.Open(path))
+    return false;
 
-      memcpy(hex, line + 15, 4);
-      blk.d = ParseBlock(hex);
+  ParseRdsSpyData(file.data(), file.size(), blocks);
+  return true;
+}
 
-      blocks->push_back(std::move(blk));
-    }
+bool ParseRdsSpyTimestamp(const char* text, size_t len, int64_t* timestamp) {
+  // 0123456789012345678901
+  // 2019/05/04 02:29:17.94
+  if (len != 22 && len != 23)
+    return false;
+  if (text[4] != '/' || text[7] != '/' || text[10] != ' ' || text[13] != ':' ||
+      text[16] != ':' || text[19] != '.') {
+    return false;
   }
 
-  fclose(f);
+  const int century = ParseTwoDigits(text + 0);
+  const int year = ParseTwoDigits(text + 2);
+  const int month = ParseTwoDigits(text + 5);
+  const int day = ParseTwoDigits(text + 8);
+  const int hour = ParseTwoDigits(text + 11);
+  const int minute = ParseTwoDigits(text + 14);
+  const int second = ParseTwoDigits(text + 17);
+  int millis = ParseTwoDigits(text + 20);
+  if ((century | year | month | day | hour | minute | second | millis) < 0)
+    return false;
+  if (len == 23) {
+    const unsigned last = text[22] - '0';
+    if (last > 9)
+      return false;
+    millis = millis * 10 + last;
+  } else {
+    millis *= 10;  // Hundredths of a second.
+  }
+  if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 ||
+      minute > 59 || second > 60) {
+    return false;
+  }
 
+  const int64_t days = DaysFromCivil(century * 100 + year, month, day);
+  *timestamp =
+      ((days * 24 + hour) * 60 + minute) * 60 * 1000 + second * 1000 + millis;
   return true;
 }
@@ -19,13 +19,153 @@
 #include <vector>
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include <rds_decoder.h>
+#include "block_line_decoder.h"
+#include "block_reader.h"
+#include "mapped_file.h"
+
+/**
+ * Counts of the lines examined while parsing an RDS Spy log.
+ *
+ * Blank lines and "<tag=value>" header lines are expected, and are not
+ * counted.
+ */
+struct RdsSpyParseCounters {
+  uint64_t lines_parsed = 0;    ///< Block lines successfully parsed.
+  uint64_t lines_rejected = 0;  ///< Malformed (e.g. truncated) lines skipped.
+  uint64_t partial_blocks = 0;  ///< Parsed lines with one or more missing
+                                ///< ("----" or malformed) blocks.
+
+  RdsSpyParseCounters& operator+=(const RdsSpyParseCounters& other);
+};
+
+/**
+ * Reads the blocks of an RDS Spy log one group at a time.
+ *
+ * Unlike LoadRdsSpyFile the whole log is never held in memory. The file is
+ * read ahead of the current position, and released behind it, so memory use
+ * is constant and file I/O overlaps with the processing of each group.
+ */
+class RdsSpyLogReader : public BlockReader {
+ public:
+  RdsSpyLogReader();
+  ~RdsSpyLogReader() override;
+
+  /**
+   * Open the RDS Spy log at \p path for reading.
+   *
+   * @return true if successful.
+   */
+  bool Open(const std::string& path);
+
+  /// Counts of the lines read so far.
+  const RdsSpyParseCounters& counters() const { return counters_; }
+
+  // BlockReader:
+  bool Next(struct rds_blocks* blocks, int64_t* timestamp) override;
+
+ private:
+  MappedFile file_;
+  BlockLineDecoder decoder_;
+  const char* pos_;  ///< Start of the next line to read.
+  RdsSpyParseCounters counters_;
+};
+
+/**
+ * Reads the blocks of (part of) an RDS Spy log which is already in memory.
+ *
+ * The buffer must remain valid while the reader is in use.
+ */
+class RdsSpyBufferReader : public BlockReader {
+ public:
+  /**
+   * @param data The log contents. This should begin at the start of a line.
+   * @param size The number of bytes in \p data.
+   */
+  RdsSpyBufferReader(const char* data, size_t size);
+  ~RdsSpyBufferReader() override;
+
+  /// Counts of the lines read so far.
+  const RdsSpyParseCounters& counters() const { return counters_; }
+
+  // BlockReader:
+  bool Next(struct rds_blocks* blocks, int64_t* timestamp) override;
+
+ private:
+  BlockLineDecoder decoder_;
+  const char* pos_;  ///< Start of the next line to read.
+  const char* end_;  ///< The end of the buffer.
+  RdsSpyParseCounters counters_;
+};
+
+/**
+ * Reads the blocks of an RDS Spy log which is received incrementally, for
+ * example from a pipe or a file which is still being written.
+ *
+ * Data is added with Append() as it arrives, and Next() returns the groups
+ * of all complete lines received so far.
+ */
+class RdsSpyStreamReader : public BlockReader {
+ public:
+  RdsSpyStreamReader();
+  ~RdsSpyStreamReader() override;
+
+  /**
+   * Add data received from the stream.
+   */
+  void Append(const char* data, size_t size);
+
+  /**
+   * Indicate that the stream has ended, so that a final line without a line
+   * terminator can be read.
+   */
+  void Finish();
+
+  /// Counts of the lines read so far.
+  const RdsSpyParseCounters& counters() const { return counters_; }
+
+  // BlockReader:
+  //
+  // Returns false if no complete lines remain. More may become available
+  // after the next call to Append().
+  bool Next(struct rds_blocks* blocks, int64_t* timestamp) override;
+
+ private:
+  BlockLineDecoder decoder_;
+  std::string buffer_;   ///< Data received but not yet fully read.
+  size_t pos_;           ///< Offset of the next line to read.
+  size_t complete_end_;  ///< Offset of the end of the last complete line.
+  RdsSpyParseCounters counters_;
+};
+
+/**
+ * Parse the block lines of an in-memory RDS Spy log.
+ *
+ * The buffer is scanned in place - no lines are copied. Lines that are not
+ * block lines (headers, comments, malformed lines, etc.) are skipped.
+ *
+ * @param data     The log file contents.
+ * @param size     The number of bytes in \p data.
+ * @param blocks   The vector of blocks to be populated. New blocks will be
+ *                 pushed to the back of this vector.
+ * @param counters If not null, updated with the lines examined.
+ *
+ * @return The number of blocks added to \p blocks.
+ */
+size_t ParseRdsSpyData(const char* data,
+                       size_t size,
+                       std::vector<struct rds_blocks>* blocks,
+                       RdsSpyParseCounters* counters = nullptr);
 
 /**
  * Read in the contents of a RDS Spy data file, and populate a vector of
  * rds_blocks with those contents.
  *
+ * This is a convenience wrapper around MappedFile and ParseRdsSpyData.
+ *
  * @param path   The path to the RDS Spy data file.
  * @param blocks The vector of blocks to be populated. New blocks will be
  *               pushed to the back of this vector.
@@ -34,3 +174,17 @@
  */
 bool LoadRdsSpyFile(const std::string& path,
                     std::vector<struct rds_blocks>* blocks);
+
+/**
+ * Parse the timestamp of an RDS Spy block line.
+ *
+ * @param text      The timestamp, which follows the '@' on a block line. For
+ *                  example "2019/05/04 02:29:17.94" or
+ *                  "2019/05/04 02:29:17.940".
+ * @param len       The number of characters in \p text.
+ * @param timestamp Set to the parsed time in milliseconds since the Unix
+ *                  epoch. The time zone is whatever the log was recorded in.
+ *
+ * @return true if \p text is a valid timestamp.
+ */
+bool ParseRdsSpyTimestamp(const char* text, size_t len, int64_t* timestamp);
@@ -0,0 +1,54 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <iostream>
+#include <memory>
+
+#include <rds_decoder.h>
+#include "rds_block_archive.h"
+#include "rds_spy_log_reader.h"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+int main(int argc, const char** argv) {
+  BlockArchiveCodec codec = BlockArchiveCodec::kPredictive;
+  if (argc == 4 && strcmp(argv[1], "--raw") == 0) {
+    codec = BlockArchiveCodec::kRaw;
+    argc--;
+    argv++;
+  }
+  if (argc != 3) {
+    cerr << "usage rdsconvert [--raw] <path/to/rdsspy.log> "
+            "<path/to/archive.rba>"
+         << endl;
+    return 1;
+  }
+
+  RdsSpyLogReader reader;
+  if (!reader.Open(argv[1])) {
+    cerr << "Can't read \"" << argv[1] << '\"' << endl;
+    return 2;
+  }
+
+  RdsBlockArchiveWriter writer;
+  if (!writer.Open(argv[2], codec)) {
+    cerr << "Can't create \"" << argv[2] << '\"' << endl;
+    return 2;
+  }
+
+  struct rds_blocks blocks;
+  int64_t timestamp;
+  while (reader.Next(&blocks, &timestamp)) {
+    if (!writer.Write(blocks, timestamp))
+      return 4;
+  }
+
+  if (!writer.Close())
+    return 4;
+
+  cout << "Wrote " << writer.group_count() << " groups to " << argv[2]
+       << endl;
+  return 0;
+}
@@ -0,0 +1,231 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <rds_decoder.h>
+#include "mpx_demodulator.h"
+#include "rds_block_archive.h"
+
+using std::cerr;
+using std::endl;
+
+namespace {
+
+const int kDefaultSampleRate = 171000;
+const size_t kReadSamples = 64 * 1024;
+
+enum class SampleFormat {
+  kS16,  ///< Signed 16-bit little endian, e.g. from "rtl_fm -s 171k".
+  kF32,  ///< 32-bit float.
+};
+
+/**
+ * Writes each group received from the bitstream synchronizer.
+ */
+class GroupWriter {
+ public:
+  GroupWriter(int sample_rate, RdsBlockArchiveWriter* archive)
+      : sample_rate_(sample_rate),
+        archive_(archive),
+        start_time_(std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count()),
+        bitstream_(nullptr),
+        samples_(0),
+        read_samples_(0),
+        read_first_bit_(0),
+        read_bits_(0),
+        ok_(true) {}
+
+  static void OnGroup(const struct rds_blocks* blocks, void* cb_data) {
+    static_cast<GroupWriter*>(cb_data)->Write(*blocks);
+  }
+
+  /// Set the bitstream whose groups are written, to find their bit positions.
+  void set_bitstream(const struct rds_bitstream* bitstream) {
+    bitstream_ = bitstream;
+  }
+
+  /**
+   * Note that the next \p num_bits bits pushed to the bitstream were
+   * demodulated from the next \p num_samples samples.
+   *
+   * Groups are timestamped with the MPX time of their last bit, so that
+   * groups decoded from one read aren't all given the same time.
+   */
+  void AddSamples(size_t num_samples, size_t num_bits) {
+    samples_ += read_samples_;
+    read_samples_ = num_samples;
+    read_first_bit_ = rds_bitstream_get_stats(bitstream_)->bits;
+    read_bits_ = num_bits;
+  }
+
+  bool ok() const { return ok_; }
+
+ private:
+  void Write(const struct rds_blocks& blocks) {
+    // The bits are spread evenly over the samples they were demodulated from.
+    const uint32_t bit =
+        rds_bitstream_get_stats(bitstream_)->bits - read_first_bit_;
+    const int64_t sample =
+        samples_ + (read_bits_ ? bit * read_samples_ / read_bits_ : 0);
+    const int64_t timestamp = start_time_ + sample * 1000 / sample_rate_;
+    if (archive_) {
+      ok_ = ok_ && archive_->Write(blocks, timestamp);
+      return;
+    }
+    // An RDS Spy log line, with "----" for uncorrectable blocks:
+    //
+    // F202 2410 4652 414E @2019/05/04 02:29:17.94
+    char line[64];
+    char* pos = line;
+    for (const struct rds_block* block :
+         {&blocks.a, &blocks.b, &blocks.c, &blocks.d}) {
+      if (block->errors == BLER_6_PLUS)
+        pos += sprintf(pos, "---- ");
+      else
+        pos += sprintf(pos, "%04X ", block->val);
+    }
+    const time_t secs = static_cast<time_t>(timestamp / 1000);
+    struct tm tm;
+    localtime_r(&secs, &tm);
+    pos += strftime(pos, line + sizeof(line) - pos, "@%Y/%m/%d %H:%M:%S", &tm);
+    sprintf(pos, ".%02d\n", static_cast<int>(timestamp % 1000 / 10));
+    ok_ = ok_ && fputs(line, stdout) >= 0;
+  }
+
+  const int sample_rate_;
+  RdsBlockArchiveWriter* archive_;
+  const int64_t start_time_;  ///< Milliseconds since the epoch.
+  const struct rds_bitstream* bitstream_;
+  int64_t samples_;          ///< Samples demodulated before this read.
+  int64_t read_samples_;     ///< Samples in this read.
+  uint32_t read_first_bit_;  ///< Bits pushed before this read's bits.
+  int64_t read_bits_;        ///< Bits demodulated from this read.
+  bool ok_;
+};
+
+/**
+ * Read up to \p max samples from \p file, converted to float.
+ *
+ * @return The number of samples read.
+ */
+size_t ReadSamples(FILE* file,
+                   SampleFormat format,
+                   size_t max,
+                   std::vector<float>* samples) {
+  samples->resize(max);
+  if (format == SampleFormat::kF32)
+    return fread(samples->data(), sizeof(float), max, file);
+
+  std::vector<int16_t> raw(max);
+  const size_t count = fread(raw.data(), sizeof(int16_t), max, file);
+  for (size_t i = 0; i < count; i++)
+    (*samples)[i] = raw[i] * (1.0f / 32768);
+  return count;
+}
+
+void PrintStats(const struct rds_bitstream_stats& stats) {
+  cerr << "Bits: " << stats.bits << ", blocks: " << stats.blocks
+       << ", corrected: " << stats.corrected_blocks
+       << ", uncorrectable: " << stats.uncorrectable_blocks
+       << ", soft corrected: " << stats.soft_corrected_blocks
+       << ", groups: " << stats.groups << ", syncs: " << stats.syncs
+       << ", sync losses: " << stats.sync_losses << endl;
+}
+
+void PrintUsage() {
+  cerr << "usage rdsdemod [-r rate] [-t s16|f32] [-o archive.rba] "
+          "<path/to/mpx | ->"
+       << endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int sample_rate = kDefaultSampleRate;
+  SampleFormat format = SampleFormat::kS16;
+  const char* archive_path = nullptr;
+  int opt;
+  while ((opt = getopt(argc, argv, "o:r:t:")) != -1) {
+    switch (opt) {
+      case 'o':
+        archive_path = optarg;
+        break;
+      case 'r':
+        sample_rate = atoi(optarg);
+        break;
+      case 't':
+        if (strcmp(optarg, "s16") == 0) {
+          format = SampleFormat::kS16;
+        } else if (strcmp(optarg, "f32") == 0) {
+          format = SampleFormat::kF32;
+        } else {
+          PrintUsage();
+          return 1;
+        }
+        break;
+      default:
+        PrintUsage();
+        return 1;
+    }
+  }
+  if (optind != argc - 1) {
+    PrintUsage();
+    return 1;
+  }
+  if (!MpxDemodulator::IsValidSampleRate(sample_rate)) {
+    cerr << "Sample rate must be a multiple of 19000, and at least 133000"
+         << endl;
+    return 1;
+  }
+
+  const std::string path = argv[optind];
+  FILE* file = path == "-" ? stdin : fopen(path.c_str(), "rb");
+  if (!file) {
+    cerr << "Can't read \"" << path << '\"' << endl;
+    return 2;
+  }
+
+  RdsBlockArchiveWriter archive;
+  if (archive_path &&
+      !archive.Open(archive_path, BlockArchiveCodec::kPredictive)) {
+    cerr << "Can't create \"" << archive_path << '\"' << endl;
+    return 2;
+  }
+
+  GroupWriter writer(sample_rate, archive_path ? &archive : nullptr);
+  const struct rds_bitstream_config config = {GroupWriter::OnGroup, &writer};
+  struct rds_bitstream* bitstream = rds_bitstream_create(&config);
+  writer.set_bitstream(bitstream);
+  MpxDemodulator demodulator(sample_rate, GetBestMpxKernelType());
+
+  std::vector<float> samples;
+  std::vector<int8_t> llrs;
+  size_t count;
+  while ((count = ReadSamples(file, format, kReadSamples, &samples)) > 0) {
+    llrs.clear();
+    demodulator.ProcessSoft(samples.data(), count, &llrs);
+    writer.AddSamples(count, llrs.size());
+    rds_bitstream_push_soft_bits(bitstream, llrs.data(), llrs.size());
+    if (!writer.ok())
+      break;
+  }
+  if (file != stdin)
+    fclose(file);
+
+  PrintStats(*rds_bitstream_get_stats(bitstream));
+  rds_bitstream_delete(bitstream);
+
+  if (!writer.ok() || (archive_path && !archive.Close()))
+    return 4;
+  return 0;
+}
@@ -1,11 +1,26 @@
+#include <dirent.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include <rds_decoder.h>
+#include "block_reader.h"
+#include "mapped_file.h"
+#include "rds_block_archive.h"
 #include "rds_spy_log_reader.h"
+#include "stream_follower.h"
+#include "work_stealing_pool.h"
 
 using std::cerr;
 using std::cout;
@@ -33,41 +48,91 @@ struct ODAStats {
   int itunes_cnt = 0;
 };
 
-void PrintStats(const rds_data& rds_data, const ODAStats& oda_stats) {
+/**
+ * Named statistic values, in display order.
+ */
+typedef std::vector<std::pair<std::string, int>> Stats;
+
+Stats CollectStats(const rds_data& rds_data, const ODAStats& oda_stats) {
+  Stats stats;
 #if defined(RDS_DEV)
-  cout << "RDS: " << rds_data.stats.data_cnt << endl;
-  cout << "BERR: " << rds_data.stats.blckb_errors << endl;
+  stats.emplace_back("RDS", rds_data.stats.data_cnt);
+  stats.emplace_back("BERR", rds_data.stats.blckb_errors);
   for (int i = 0; i < 16; i++) {
-    cout << i << "A: " << rds_data.stats.groups[i].a << endl;
-    cout << i << "B: " << rds_data.stats.groups[i].b << endl;
-  }
-
-  cout << "AF: " << rds_data.stats.counts[PKTCNT_AF] << endl;
-  cout << "CLOCK: " << rds_data.stats.counts[PKTCNT_CLOCK] << endl;
-  cout << "EON: " << rds_data.stats.counts[PKTCNT_EON] << endl;
-  cout << "EWS: " << rds_data.stats.counts[PKTCNT_EWS] << endl;
-  cout << "FBT: " << rds_data.stats.counts[PKTCNT_FBT] << endl;
-  cout << "IH: " << rds_data.stats.counts[PKTCNT_IH] << endl;
-  cout << "MS: " << rds_data.stats.counts[PKTCNT_MS] << endl;
-  cout << "PAGING: " << rds_data.stats.counts[PKTCNT_PAGING] << endl;
-  cout << "PI_CODE: " << rds_data.stats.counts[PKTCNT_PI_CODE] << endl;
-  cout << "PS: " << rds_data.stats.counts[PKTCNT_PS] << endl;
-  cout << "PTY: " << rds_data.stats.counts[PKTCNT_PTY] << endl;
-  cout << "PTYN: " << rds_data.stats.counts[PKTCNT_PTYN] << endl;
-  cout << "RT: " << rds_data.stats.counts[PKTCNT_RT] << endl;
-  cout << "SLC: " << rds_data.stats.counts[PKTCNT_SLC] << endl;
-  cout << "TA_CODE: " << rds_data.stats.counts[PKTCNT_TA_CODE] << endl;
-  cout << "TDC: " << rds_data.stats.counts[PKTCNT_TDC] << endl;
-  cout << "TMC: " << rds_data.stats.counts[PKTCNT_TMC] << endl;
-  cout << "TP_CODE: " << rds_data.stats.counts[PKTCNT_TP_CODE] << endl;
-
-  cout << "RT+: " << oda_stats.rtplus_cnt << endl;
-  cout << "RDS-TMC: " << oda_stats.tmc_cnt << endl;
-  cout << "iTunes: " << oda_stats.itunes_cnt << endl;
+    stats.emplace_back(std::to_string(i) + "A", rds_data.stats.groups[i].a);
+    stats.emplace_back(std::to_string(i) + "B", rds_data.stats.groups[i].b);
+  }
+
+  stats.emplace_back("AF", rds_data.stats.counts[PKTCNT_AF]);
+  stats.emplace_back("CLOCK", rds_data.stats.counts[PKTCNT_CLOCK]);
+  stats.emplace_back("EON", rds_data.stats.counts[PKTCNT_EON]);
+  stats.emplace_back("EWS", rds_data.stats.counts[PKTCNT_EWS]);
+  stats.emplace_back("FBT", rds_data.stats.counts[PKTCNT_FBT]);
+  stats.emplace_back("IH", rds_data.stats.counts[PKTCNT_IH]);
+  stats.emplace_back("MS", rds_data.stats.counts[PKTCNT_MS]);
+  stats.emplace_back("PAGING", rds_data.stats.counts[PKTCNT_PAGING]);
+  stats.emplace_back("PI_CODE", rds_data.stats.counts[PKTCNT_PI_CODE]);
+  stats.emplace_back("PS", rds_data.stats.counts[PKTCNT_PS]);
+  stats.emplace_back("PTY", rds_data.stats.counts[PKTCNT_PTY]);
+  stats.emplace_back("PTYN", rds_data.stats.counts[PKTCNT_PTYN]);
+  stats.emplace_back("RT", rds_data.stats.counts[PKTCNT_RT]);
+  stats.emplace_back("SLC", rds_data.stats.counts[PKTCNT_SLC]);
+  stats.emplace_back("TA_CODE", rds_data.stats.counts[PKTCNT_TA_CODE]);
+  stats.emplace_back("TDC", rds_data.stats.counts[PKTCNT_TDC]);
+  stats.emplace_back("TMC", rds_data.stats.counts[PKTCNT_TMC]);
+  stats.emplace_back("TP_CODE", rds_data.stats.counts[PKTCNT_TP_CODE]);
+
+  stats.emplace_back("RT+", oda_stats.rtplus_cnt);
+  stats.emplace_back("RDS-TMC", oda_stats.tmc_cnt);
+  stats.emplace_back("iTunes", oda_stats.itunes_cnt);
 #else
   UNUSED(rds_data);
   UNUSED(oda_stats);
 #endif
+  return stats;
+}
+
+/**
+ * Add the statistics counters of \p from to those of \p to.
+ *
+ * The counters are added at their native width so the sums wrap exactly as
+ * they would if all groups had been decoded into \p to.
+ */
+void AddStats(const rds_data& from, rds_data* to) {
+#if defined(RDS_DEV)
+  for (int i = 0; i < PKTCNT_NUM; i++)
+    to->stats.counts[i] += from.stats.counts[i];
+  for (int i = 0; i < 16; i++) {
+    to->stats.groups[i].a += from.stats.groups[i].a;
+    to->stats.groups[i].b += from.stats.groups[i].b;
+  }
+  to->stats.data_cnt += from.stats.data_cnt;
+  to->stats.blckb_errors += from.stats.blckb_errors;
+#else
+  UNUSED(from);
+  UNUSED(to);
+#endif
+}
+
+void AddStats(const ODAStats& from, ODAStats* to) {
+  to->rtplus_cnt += from.rtplus_cnt;
+  to->tmc_cnt += from.tmc_cnt;
+  to->itunes_cnt += from.itunes_cnt;
+}
+
+void PrintStats(const Stats& stats) {
+  for (const auto& stat : stats)
+    cout << stat.first << ": " << stat.second << endl;
+}
+
+/**
+ * Print the line counters of the RDS Spy log at \p path to stderr.
+ */
+void PrintCounters(const std::string& path,
+                   const RdsSpyParseCounters& counters) {
+  cerr << '\"' << path << "\": " << counters.lines_parsed
+       << " lines parsed, " << counters.lines_rejected << " rejected, "
+       << counters.partial_blocks << " partial blocks" << endl;
 }
 
 void DecodeODA(uint16_t app_id,
@@ -101,41 +166,508 @@ void ClearODA(void* user_data) {
   *oda_stats = ODAStats();
 }
 
+/**
+ * An RDS decoder, and the data it decodes into, used to gather statistics.
+ */
+class StatsDecoder {
+ public:
+  StatsDecoder() {
+    memset(&rds_data_, 0, sizeof(rds_data_));
+    const rds_decoder_config config = {
+        .advanced_ps_decoding = true,
+        .rds_data = &rds_data_,
+    };
+    decoder_ = rds_decoder_create(&config);
+    rds_decoder_set_oda_callbacks(decoder_, DecodeODA, ClearODA, &oda_stats_);
+  }
+
+  ~StatsDecoder() { rds_decoder_delete(decoder_); }
+
+  StatsDecoder(const StatsDecoder&) = delete;
+  StatsDecoder& operator=(const StatsDecoder&) = delete;
+
+  void Reset() { rds_decoder_reset(decoder_); }
+
+  /**
+   * Continue decoding from \p state, a copy of the data of another decoder,
+   * with all statistics cleared.
+   */
+  void Restore(const rds_data& state) {
+    rds_data_ = state;
+#if defined(RDS_DEV)
+    memset(&rds_data_.stats, 0, sizeof(rds_data_.stats));
+#endif
+    oda_stats_ = ODAStats();
+  }
+
+  void Decode(const struct rds_blocks& blocks, int64_t timestamp = 0) {
+    rds_decoder_decode_ts(decoder_, &blocks, timestamp);
+  }
+
+  /**
+   * Decode every group in \p reader.
+   *
+   * @return The number of groups decoded.
+   */
+  size_t Decode(BlockReader* reader) {
+    // Decode each group, with the time it was logged, as it is read so that
+    // memory use does not depend on the size of the log.
+    size_t num_groups = 0;
+    struct rds_blocks blocks;
+    int64_t timestamp;
+    while (reader->Next(&blocks, &timestamp)) {
+      Decode(blocks, timestamp);
+      num_groups++;
+    }
+    return num_groups;
+  }
+
+  /**
+   * Reset the decoder, and decode every group in \p reader.
+   *
+   * @return The number of groups decoded.
+   */
+  size_t DecodeAll(BlockReader* reader) {
+    Reset();
+    return Decode(reader);
+  }
+
+  const rds_data& data() const { return rds_data_; }
+  const ODAStats& oda_stats() const { return oda_stats_; }
+
+  Stats GetStats() const { return CollectStats(rds_data_, oda_stats_); }
+
+ private:
+  struct rds_data rds_data_;
+  ODAStats oda_stats_;
+  rds_decoder* decoder_;
+};
+
+bool IsDirectory(const std::string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool HasSuffix(const std::string& str, const char* suffix) {
+  const size_t len = strlen(suffix);
+  return str.size() >= len && str.compare(str.size() - len, len, suffix) == 0;
+}
+
+/**
+ * Recursively find all RDS Spy logs and block archives in \p dir.
+ */
+void FindLogFiles(const std::string& dir, std::vector<std::string>* files) {
+  DIR* d = opendir(dir.c_str());
+  if (d == nullptr) {
+    perror(dir.c_str());
+    return;
+  }
+  struct dirent* entry;
+  while ((entry = readdir(d)) != nullptr) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+      continue;
+    const std::string path =
+        dir.back() == '/' ? dir + entry->d_name : dir + '/' + entry->d_name;
+    if (IsDirectory(path))
+      FindLogFiles(path, files);
+    else if (HasSuffix(path, ".spy") || HasSuffix(path, ".rba"))
+      files->push_back(path);
+  }
+  closedir(d);
+}
+
+/**
+ * Write a CSV field, quoting it if necessary.
+ */
+void WriteCsvField(std::ostream& out, const std::string& field) {
+  if (field.find_first_of(",\"\n") == std::string::npos) {
+    out << field;
+    return;
+  }
+  out << '"';
+  for (char c : field) {
+    if (c == '"')
+      out << '"';
+    out << c;
+  }
+  out << '"';
+}
+
+/**
+ * Is \p blocks a group which changes decoder state that the statistics of
+ * later groups depend on?
+ *
+ * These are 3A (which assigns group types to ODAs) and 5A (which selects the
+ * TDC channel counted by 5B groups).
+ */
+bool IsStateGroup(const struct rds_blocks& blocks) {
+  const uint16_t code = blocks.b.val >> 11;  // Group type and version.
+  return code == (3 << 1) || code == (5 << 1);
+}
+
+/**
+ * A range of lines of an RDS Spy log, decoded by a single task.
+ */
+struct LogChunk {
+  const char* data;
+  size_t size;
+  std::vector<struct rds_blocks> state_groups;
+  std::unique_ptr<rds_data> start_state;  ///< nullptr for the first chunk.
+  std::unique_ptr<rds_data> end_data;     ///< Data after decoding the chunk.
+  ODAStats oda_stats;
+  RdsSpyParseCounters counters;
+  size_t num_groups = 0;
+};
+
+/**
+ * The state of a log being processed by ProcessDirectory.
+ */
+struct LogFile {
+  std::string path;
+  bool readable = true;
+  bool is_archive = false;
+  MappedFile file;  ///< Only used for RDS Spy logs.
+  std::vector<LogChunk*> chunks;
+  RdsSpyParseCounters counters;  ///< Only used for RDS Spy logs.
+  Stats stats;
+};
+
+/**
+ * Logs are split into chunks of about this many bytes so that a large log
+ * can be decoded by several threads.
+ */
+const size_t kLogChunkSize = 16 * 1024 * 1024;
+
+/**
+ * Split the RDS Spy log \p log into chunks, ending each at a line break.
+ */
+void SplitLog(LogFile* log, std::vector<std::unique_ptr<LogChunk>>* chunks) {
+  const char* pos = log->file.data();
+  const char* end = log->file.end();
+  while (pos < end) {
+    const char* chunk_end = end;
+    if (static_cast<size_t>(end - pos) > kLogChunkSize) {
+      const char* eol = static_cast<const char*>(
+          memchr(pos + kLogChunkSize, '\n', end - pos - kLogChunkSize));
+      if (eol != nullptr)
+        chunk_end = eol + 1;
+    }
+    LogChunk* chunk = new LogChunk();
+    chunks->emplace_back(chunk);
+    chunk->data = pos;
+    chunk->size = chunk_end - pos;
+    log->chunks.push_back(chunk);
+    pos = chunk_end;
+  }
+}
+
+/**
+ * Gather the statistics of every log in \p dir (recursively), and write them
+ * as a CSV file, with one row per log, to \p out. The line counters of RDS
+ * Spy logs are included, and are empty for block archives.
+ *
+ * Each RDS Spy log is split into chunks so that one large log doesn't leave
+ * all but one thread idle. The statistics of a group depend on earlier 3A and
+ * 5A groups, so each chunk is decoded starting from the decoder state left by
+ * those groups in the preceding chunks. Block archives can't be split, and
+ * are decoded as a single task.
+ *
+ * @param dir      The directory to scan.
+ * @param num_jobs The number of threads used to decode the logs.
+ * @param out      The stream to which the CSV is written.
+ *
+ * @return The process exit code.
+ */
+int ProcessDirectory(const std::string& dir,
+                     unsigned num_jobs,
+                     std::ostream& out) {
+  std::vector<std::string> files;
+  FindLogFiles(dir, &files);
+  std::sort(files.begin(), files.end());
+  if (files.empty()) {
+    cerr << "No logs found in \"" << dir << '\"' << endl;
+    return 3;
+  }
+
+  std::vector<std::unique_ptr<LogFile>> logs;
+  std::vector<LogFile*> archives;
+  std::vector<std::unique_ptr<LogChunk>> chunks;
+  for (const auto& path : files) {
+    LogFile* log = new LogFile();
+    logs.emplace_back(log);
+    log->path = path;
+    log->is_archive = IsBlockArchive(path);
+    if (log->is_archive)
+      archives.push_back(log);
+    else if (log->file.Open(path))
+      SplitLog(log, &chunks);
+    else
+      log->readable = false;
+  }
+
+  WorkStealingPool pool(std::max(1u, num_jobs));
+
+  // Find the state groups in every chunk which has a successor.
+  for (const auto& log : logs) {
+    for (size_t i = 0; i + 1 < log->chunks.size(); i++) {
+      LogChunk* chunk = log->chunks[i];
+      pool.Add([chunk]() {
+        RdsSpyBufferReader reader(chunk->data, chunk->size);
+        struct rds_blocks blocks;
+        while (reader.Next(&blocks, nullptr)) {
+          if (IsStateGroup(blocks))
+            chunk->state_groups.push_back(blocks);
+        }
+      });
+    }
+  }
+  pool.Run();
+
+  // Replay the state groups to find the state each chunk starts from. These
+  // are a tiny fraction of all groups, so this is quick.
+  for (const auto& log : logs) {
+    if (log->chunks.size() < 2)
+      continue;
+    StatsDecoder decoder;
+    decoder.Reset();
+    for (size_t i = 1; i < log->chunks.size(); i++) {
+      LogChunk* prev = log->chunks[i - 1];
+      for (const auto& blocks : prev->state_groups)
+        decoder.Decode(blocks);
+      prev->state_groups.clear();
+      log->chunks[i]->start_state.reset(new rds_data(decoder.data()));
+    }
+  }
+
+  for (LogFile* log : archives) {
+    pool.Add([log]() {
+      std::unique_ptr<BlockReader> reader = OpenBlockReader(log->path);
+      if (!reader) {
+        log->readable = false;
+        return;
+      }
+      StatsDecoder decoder;
+      if (decoder.DecodeAll(reader.get()) != 0)
+        log->stats = decoder.GetStats();
+    });
+  }
+  for (const auto& chunk : chunks) {
+    LogChunk* c = chunk.get();
+    pool.Add([c]() {
+      StatsDecoder decoder;
+      if (c->start_state)
+        decoder.Restore(*c->start_state);
+      else
+        decoder.Reset();
+      RdsSpyBufferReader reader(c->data, c->size);
+      c->num_groups = decoder.Decode(&reader);
+      c->end_data.reset(new rds_data(decoder.data()));
+      c->oda_stats = decoder.oda_stats();
+      c->counters = reader.counters();
+    });
+  }
+  pool.Run();
+
+  // Combine the chunk statistics of each log.
+  for (const auto& log : logs) {
+    if (log->chunks.empty())
+      continue;
+    std::unique_ptr<rds_data> data(new rds_data());
+    memset(data.get(), 0, sizeof(*data));
+    ODAStats oda_stats;
+    size_t num_groups = 0;
+    for (const LogChunk* chunk : log->chunks) {
+      AddStats(*chunk->end_data, data.get());
+      AddStats(chunk->oda_stats, &oda_stats);
+      log->counters += chunk->counters;
+      num_groups += chunk->num_groups;
+    }
+    if (num_groups != 0)
+      log->stats = CollectStats(*data, oda_stats);
+  }
+
+  // A file which can't be read, or is empty, is skipped.
+  const size_t prefix_len = dir.back() == '/' ? dir.size() : dir.size() + 1;
+  bool wrote_header = false;
+  for (const auto& log : logs) {
+    if (!log->readable) {
+      cerr << "Can't read \"" << log->path << '\"' << endl;
+      continue;
+    }
+    const Stats& stats = log->stats;
+    if (stats.empty()) {
+      cerr << '\"' << log->path << "\" is empty" << endl;
+      continue;
+    }
+    if (!wrote_header) {
+      out << "File,Lines,Rejected,Partial";
+      for (const auto& stat : stats) {
+        out << ',';
+        WriteCsvField(out, stat.first);
+      }
+      out << endl;
+      wrote_header = true;
+    }
+    WriteCsvField(out, log->path.substr(prefix_len));
+    if (log->is_archive) {
+      out << ",,,";
+    } else {
+      out << ',' << log->counters.lines_parsed << ','
+          << log->counters.lines_rejected << ','
+          << log->counters.partial_blocks;
+    }
+    for (const auto& stat : stats)
+      out << ',' << stat.second;
+    out << '\n';
+  }
+  out.flush();
+  return 0;
+}
+
+/**
+ * Decode an RDS Spy log as it is received from \p follower, printing the
+ * statistics every \p interval_secs seconds, and once the stream ends.
+ *
+ * @return The process exit code.
+ */
+int ProcessStream(StreamFollower* follower, int interval_secs) {
+  typedef std::chrono::steady_clock Clock;
+  const Clock::duration interval = std::chrono::seconds(interval_secs);
+
+  RdsSpyStreamReader reader;
+  StatsDecoder decoder;
+  decoder.Reset();
+  size_t num_groups = 0;
+  Clock::time_point next_print = Clock::now() + interval;
+  std::vector<char> buffer(64 * 1024);
+  while (true) {
+    const Clock::time_point now = Clock::now();
+    if (now >= next_print) {
+      if (num_groups != 0) {
+        PrintStats(decoder.GetStats());
+        cout << endl;
+      }
+      next_print = now + interval;
+    }
+    const int timeout_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(next_print - now)
+            .count();
+    const ssize_t bytes_read =
+        follower->Read(buffer.data(), buffer.size(), timeout_ms);
+    if (bytes_read < 0)
+      break;
+    reader.Append(buffer.data(), bytes_read);
+    struct rds_blocks blocks;
+    int64_t timestamp;
+    while (reader.Next(&blocks, &timestamp)) {
+      decoder.Decode(blocks, timestamp);
+      num_groups++;
+    }
+  }
+
+  reader.Finish();
+  struct rds_blocks blocks;
+  int64_t timestamp;
+  while (reader.Next(&blocks, &timestamp)) {
+    decoder.Decode(blocks, timestamp);
+    num_groups++;
+  }
+  if (num_groups == 0) {
+    cerr << "No groups received" << endl;
+    return 3;
+  }
+  PrintStats(decoder.GetStats());
+  return 0;
+}
+
+void PrintUsage() {
+  cerr << "usage rdsstats <path/to/rdsspy.log | path/to/archive.rba>" << endl;
+  cerr << "       rdsstats [-j jobs] [-o stats.csv] <path/to/log/dir>" << endl;
+  cerr << "       rdsstats [-i secs] <-f path/to/rdsspy.log | ->" << endl;
+}
+
 }  // namespace
 
-int main(int argc, const char** argv) {
-  std::vector<struct rds_blocks> file_blocks;
-  if (argc != 2) {
-    cerr << "usage rdsstats <path/to/rdsspy.log>" << endl;
+int main(int argc, char** argv) {
+  unsigned num_jobs = std::thread::hardware_concurrency();
+  const char* csv_path = nullptr;
+  bool follow = false;
+  int interval_secs = 5;
+  int opt;
+  while ((opt = getopt(argc, argv, "fi:j:o:")) != -1) {
+    switch (opt) {
+      case 'f':
+        follow = true;
+        break;
+      case 'i':
+        interval_secs = atoi(optarg);
+        if (interval_secs <= 0) {
+          PrintUsage();
+          return 1;
+        }
+        break;
+      case 'j':
+        num_jobs = atoi(optarg);
+        break;
+      case 'o':
+        csv_path = optarg;
+        break;
+      default:
+        PrintUsage();
+        return 1;
+    }
+  }
+  if (optind != argc - 1) {
+    PrintUsage();
     return 1;
   }
+  std::string path = argv[optind];
 
-  if (!LoadRdsSpyFile(argv[1], &file_blocks)) {
-    cerr << "Can't read \"" << argv[1] << '\"' << endl;
-    return 2;
+  if (path == "-") {
+    StreamFollower follower;
+    follower.OpenStdin();
+    return ProcessStream(&follower, interval_secs);
   }
-  if (file_blocks.empty()) {
-    cerr << '\"' << argv[1] << "\" is empty" << endl;
-    return 3;
+  if (follow) {
+    StreamFollower follower;
+    if (!follower.OpenFile(path)) {
+      cerr << "Can't read \"" << path << '\"' << endl;
+      return 2;
+    }
+    return ProcessStream(&follower, interval_secs);
   }
 
-  struct rds_data rds_data;
-  memset(&rds_data, 0, sizeof(rds_data));
-  ODAStats oda_stats;
+  if (IsDirectory(path)) {
+    while (path.size() > 1 && path.back() == '/')
+      path.pop_back();
+    if (!csv_path)
+      return ProcessDirectory(path, num_jobs, cout);
+    std::ofstream csv(csv_path);
+    if (!csv) {
+      cerr << "Can't create \"" << csv_path << '\"' << endl;
+      return 2;
+    }
+    return ProcessDirectory(path, num_jobs, csv);
+  }
 
-  const rds_decoder_config config = {
-      .advanced_ps_decoding = true,
-      .rds_data = &rds_data,
-  };
-  rds_decoder* decoder = rds_decoder_create(&config);
-  rds_decoder_set_oda_callbacks(decoder, DecodeODA, ClearODA, &oda_stats);
+  std::unique_ptr<BlockReader> reader = OpenBlockReader(path);
+  if (!reader) {
+    cerr << "Can't read \"" << path << '\"' << endl;
+    return 2;
+  }
 
-  for (const auto& blocks : file_blocks)
-    rds_decoder_decode(decoder, &blocks);
+  StatsDecoder decoder;
+  if (decoder.DecodeAll(reader.get()) == 0) {
+    cerr << '\"' << path << "\" is empty" << endl;
+    return 3;
+  }
 
-  rds_decoder_delete(decoder);
+  PrintStats(decoder.GetStats());
 
-  PrintStats(rds_data, oda_stats);
+  const RdsSpyLogReader* log_reader =
+      dynamic_cast<const RdsSpyLogReader*>(reader.get());
+  if (log_reader)
+    PrintCounters(path, log_reader->counters());
 
   return 0;
 }
@@ -0,0 +1,130 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stream_follower.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+StreamFollower::StreamFollower()
+    : fd_(-1), inotify_fd_(-1), file_gone_(false) {}
+
+StreamFollower::~StreamFollower() {
+  if (inotify_fd_ != -1)
+    close(inotify_fd_);
+  if (fd_ > STDIN_FILENO)
+    close(fd_);
+}
+
+void StreamFollower::OpenStdin() {
+  path_ = "stdin";
+  fd_ = STDIN_FILENO;
+}
+
+bool StreamFollower::OpenFile(const std::string& path) {
+  path_ = path;
+  fd_ = open(path.c_str(), O_RDONLY);
+  if (fd_ == -1) {
+    perror(path.c_str());
+    return false;
+  }
+  inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd_ == -1) {
+    perror("inotify_init1");
+    return false;
+  }
+  if (inotify_add_watch(inotify_fd_, path.c_str(),
+                        IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF) == -1) {
+    perror(path.c_str());
+    return false;
+  }
+  return true;
+}
+
+ssize_t StreamFollower::Read(char* buffer, size_t size, int timeout_ms) {
+  if (inotify_fd_ != -1) {
+    // Read what the file already has before waiting for it to change.
+    ssize_t bytes_read = ReadFile(buffer, size);
+    if (bytes_read != 0)
+      return bytes_read;
+    if (file_gone_ || !WaitForChange(timeout_ms))
+      return -1;
+    return ReadFile(buffer, size);
+  }
+
+  struct pollfd pfd = {fd_, POLLIN, 0};
+  const int ready = poll(&pfd, 1, timeout_ms);
+  if (ready == -1) {
+    perror("poll");
+    return -1;
+  }
+  if (ready == 0)
+    return 0;
+  const ssize_t bytes_read = read(fd_, buffer, size);
+  if (bytes_read == -1)
+    perror(path_.c_str());
+  return bytes_read > 0 ? bytes_read : -1;
+}
+
+ssize_t StreamFollower::ReadFile(char* buffer, size_t size) {
+  ssize_t bytes_read = read(fd_, buffer, size);
+  if (bytes_read == 0) {
+    // If the file was truncated (e.g. rewritten by a new recording) start
+    // again from the beginning.
+    struct stat st;
+    const off_t offset = lseek(fd_, 0, SEEK_CUR);
+    if (fstat(fd_, &st) == 0 && st.st_size < offset) {
+      lseek(fd_, 0, SEEK_SET);
+      bytes_read = read(fd_, buffer, size);
+    }
+  }
+  if (bytes_read == -1)
+    perror(path_.c_str());
+  return bytes_read;
+}
+
+bool StreamFollower::WaitForChange(int timeout_ms) {
+  struct pollfd pfd = {inotify_fd_, POLLIN, 0};
+  const int ready = poll(&pfd, 1, timeout_ms);
+  if (ready == -1) {
+    perror("poll");
+    return false;
+  }
+  if (ready == 0)
+    return true;
+
+  // Drain the events. Only deletion or renaming of the file needs action.
+  // The file is held open so it is never actually deleted (IN_DELETE_SELF),
+  // but unlinking it changes its link count (IN_ATTRIB).
+  alignas(struct inotify_event) char events[4096];
+  ssize_t len;
+  while ((len = read(inotify_fd_, events, sizeof(events))) > 0) {
+    for (const char* p = events; p < events + len;) {
+      const struct inotify_event* event =
+          reinterpret_cast<const struct inotify_event*>(p);
+      if (event->mask & IN_MOVE_SELF)
+        file_gone_ = true;
+      p += sizeof(struct inotify_event) + event->len;
+    }
+  }
+  struct stat st;
+  if (fstat(fd_, &st) == 0 && st.st_nlink == 0)
+    file_gone_ = true;
+  return true;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/**
+ * Reads data from stdin, or from a file which is still being written, as it
+ * becomes available.
+ *
+ * A followed file is watched with inotify, so no CPU is used while waiting
+ * for more data.
+ */
+class StreamFollower {
+ public:
+  StreamFollower();
+  ~StreamFollower();
+
+  StreamFollower(const StreamFollower&) = delete;
+  StreamFollower& operator=(const StreamFollower&) = delete;
+
+  /**
+   * Read from stdin until it is closed.
+   */
+  void OpenStdin();
+
+  /**
+   * Read the file at \p path, and any data appended to it, until the file is
+   * deleted or renamed.
+   *
+   * @return true if successful.
+   */
+  bool OpenFile(const std::string& path);
+
+  /**
+   * Wait up to \p timeout_ms for data, and read what is available.
+   *
+   * @param buffer     The buffer into which data is read.
+   * @param size       The size of \p buffer.
+   * @param timeout_ms The maximum time to wait for data.
+   *
+   * @return The number of bytes read (zero if the wait timed out), or -1 at
+   *         the end of the stream or on error.
+   */
+  ssize_t Read(char* buffer, size_t size, int timeout_ms);
+
+ private:
+  ssize_t ReadFile(char* buffer, size_t size);
+  bool WaitForChange(int timeout_ms);
+
+  std::string path_;
+  int fd_;          ///< The stream being read.
+  int inotify_fd_;  ///< Watches the followed file (-1 if reading stdin).
+  bool file_gone_;  ///< The followed file was deleted or renamed.
+};
@@ -0,0 +1,75 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "work_stealing_pool.h"
+
+#include <thread>
+#include <utility>
+
+WorkStealingPool::WorkStealingPool(unsigned num_threads) : next_queue_(0) {
+  if (num_threads == 0)
+    num_threads = 1;
+  for (unsigned i = 0; i < num_threads; i++)
+    queues_.emplace_back(new Queue());
+}
+
+WorkStealingPool::~WorkStealingPool() = default;
+
+void WorkStealingPool::Add(Task task) {
+  queues_[next_queue_]->tasks.push_back(std::move(task));
+  next_queue_ = (next_queue_ + 1) % queues_.size();
+}
+
+void WorkStealingPool::Run() {
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < queues_.size(); i++)
+    threads.emplace_back(&WorkStealingPool::Work, this, i);
+  Work(0);
+  for (auto& thread : threads)
+    thread.join();
+  next_queue_ = 0;
+}
+
+bool WorkStealingPool::Pop(unsigned idx, Task* task) {
+  Queue* queue = queues_[idx].get();
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  if (queue->tasks.empty())
+    return false;
+  *task = std::move(queue->tasks.front());
+  queue->tasks.pop_front();
+  return true;
+}
+
+bool WorkStealingPool::Steal(unsigned thief_idx, Task* task) {
+  for (size_t i = 1; i < queues_.size(); i++) {
+    Queue* victim = queues_[(thief_idx + i) % queues_.size()].get();
+    std::lock_guard<std::mutex> lock(victim->mutex);
+    if (victim->tasks.empty())
+      continue;
+    // Take from the opposite end to the owner to reduce contention.
+    *task = std::move(victim->tasks.back());
+    victim->tasks.pop_back();
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingPool::Work(unsigned idx) {
+  // No tasks are added while running, so once every queue is empty there is
+  // no more work for this thread.
+  Task task;
+  while (Pop(idx, &task) || Steal(idx, &task))
+    task();
+}
@@ -0,0 +1,70 @@
+/**
+ * @file
+ *
+ * @author Chris Mumford
+ *
+ * @license
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Runs a batch of tasks on a pool of threads.
+ *
+ * Each thread has its own queue of tasks. When its queue is empty a thread
+ * steals tasks from the back of the other threads' queues, so all threads
+ * stay busy even when the task sizes vary widely.
+ */
+class WorkStealingPool {
+ public:
+  typedef std::function<void()> Task;
+
+  /**
+   * @param num_threads The number of threads (including the caller's) used
+   *                    to run tasks.
+   */
+  explicit WorkStealingPool(unsigned num_threads);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  /**
+   * Add a task to be run by the next call to Run().
+   *
+   * Tasks are dealt to the threads' queues in turn, and each thread runs its
+   * own tasks in the order they were added.
+   */
+  void Add(Task task);
+
+  /**
+   * Run all added tasks, returning once they have all completed.
+   */
+  void Run();
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  bool Pop(unsigned idx, Task* task);
+  bool Steal(unsigned thief_idx, Task* task);
+  void Work(unsigned idx);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  unsigned next_queue_;  ///< The queue to which the next task is added.
+};